@@ -0,0 +1,82 @@
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QTimer>
+
+#include "AuthSecret.h"
+#include "DashboardServer.h"
+#include "DashboardWebSocketServer.h"
+#include "Logger.h"
+#include "PluginManager.h"
+
+// Headless host: the same plugins, HTTPS dashboard and WSS stream as the tray
+// app, without a GUI stack. Demand comes from websocket clients only.
+
+static std::atomic_bool quitRequested{false};
+
+static void onQuitSignal(int) {
+    quitRequested.store(true);
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    app.setApplicationName("WinAgent Daemon");
+    app.setApplicationVersion("0.2.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Headless WinAgent host (plugins + HTTPS dashboard + WSS stream).");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    const QCommandLineOption pluginsOpt("plugins", "Plugin folder (default: <exe_dir>/plugins).", "dir");
+    parser.addOption(pluginsOpt);
+    parser.process(app);
+
+    const QString pluginDir = parser.isSet(pluginsOpt)
+                                  ? QDir(parser.value(pluginsOpt)).absolutePath()
+                                  : QCoreApplication::applicationDirPath() + "/plugins";
+
+    // The servers open certs/ and dashboards/ relative to the working directory.
+    QDir::setCurrent(QCoreApplication::applicationDirPath());
+
+    // No log widget: write straight to stderr from whichever thread logs.
+    QObject::connect(&Logger::instance(), &Logger::logMessage, [](const QString &msg, const QString &, const bool) {
+        std::fprintf(stderr, "%s\n", qUtf8Printable(msg));
+    });
+
+    PluginManager plugins;
+    plugins.setGuiVisible(false);
+    plugins.loadFromDir(pluginDir, plugins.hostApi());
+
+    const QString authKey = AuthSecret::loadOrCreate();
+    Logger::info("[AUTH] Key: " + authKey + " (" + AuthSecret::path() + ")");
+
+    DashboardServer web;
+    DashboardWebSocketServer ws(&plugins);
+    ws.setAuthKey(authKey);
+
+    web.start();
+    ws.start();
+
+    // Signal handlers may only touch the flag; the event loop picks it up.
+    std::signal(SIGINT, onQuitSignal);
+    std::signal(SIGTERM, onQuitSignal);
+    QTimer quitPoll;
+    quitPoll.setTimerType(Qt::CoarseTimer);
+    quitPoll.setInterval(200);
+    QObject::connect(&quitPoll, &QTimer::timeout, &app, [] {
+        if (quitRequested.load()) QCoreApplication::quit();
+    });
+    quitPoll.start();
+
+    const int rc = app.exec();
+
+    ws.stop();
+    web.stop();
+    plugins.stopAll();
+    return rc;
+}
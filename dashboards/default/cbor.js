@@ -0,0 +1,126 @@
+// ** CBOR (RFC 8949) decoder for the server's binary frames
+
+function cborDecode(buffer) {
+    const view = new DataView(buffer);
+    const bytes = new Uint8Array(buffer);
+    const utf8 = new TextDecoder();
+    let pos = 0;
+
+    function readArg(info) {
+        if (info < 24) {
+            return info;
+        }
+        let value;
+        switch (info) {
+            case 24: value = view.getUint8(pos); pos += 1; break;
+            case 25: value = view.getUint16(pos); pos += 2; break;
+            case 26: value = view.getUint32(pos); pos += 4; break;
+            case 27: value = Number(view.getBigUint64(pos)); pos += 8; break;
+            case 31: return -1; // indefinite length
+            default: throw new Error(`CBOR: bad additional info ${info}`);
+        }
+        return value;
+    }
+
+    function readHalf() {
+        const h = view.getUint16(pos);
+        pos += 2;
+        const exp = (h >> 10) & 0x1f;
+        const frac = h & 0x3ff;
+        const sign = (h & 0x8000) ? -1 : 1;
+        if (exp === 0) {
+            return sign * frac * Math.pow(2, -24);
+        }
+        if (exp === 31) {
+            return frac ? NaN : sign * Infinity;
+        }
+        return sign * (1 + frac / 1024) * Math.pow(2, exp - 15);
+    }
+
+    function readChunks(major, len) {
+        if (len >= 0) {
+            const chunk = bytes.subarray(pos, pos + len);
+            pos += len;
+            return major === 3 ? utf8.decode(chunk) : chunk.slice();
+        }
+        const parts = [];
+        while (bytes[pos] !== 0xff) {
+            const head = bytes[pos++];
+            parts.push(readChunks(major, readArg(head & 0x1f)));
+        }
+        pos++;
+        if (major === 3) {
+            return parts.join('');
+        }
+        const out = new Uint8Array(parts.reduce((n, p) => n + p.length, 0));
+        let off = 0;
+        parts.forEach(p => {
+            out.set(p, off);
+            off += p.length;
+        });
+        return out;
+    }
+
+    function readItem() {
+        const head = bytes[pos++];
+        const major = head >> 5;
+        const info = head & 0x1f;
+
+        if (major === 7) {
+            switch (info) {
+                case 20: return false;
+                case 21: return true;
+                case 22: return null;
+                case 23: return undefined;
+                case 25: return readHalf();
+                case 26: { const v = view.getFloat32(pos); pos += 4; return v; }
+                case 27: { const v = view.getFloat64(pos); pos += 8; return v; }
+                default: return info < 24 ? info : readArg(info);
+            }
+        }
+
+        const arg = readArg(info);
+        switch (major) {
+            case 0: return arg;
+            case 1: return -1 - arg;
+            case 2:
+            case 3: return readChunks(major, arg);
+            case 4: {
+                const arr = [];
+                if (arg < 0) {
+                    while (bytes[pos] !== 0xff) {
+                        arr.push(readItem());
+                    }
+                    pos++;
+                }
+                else {
+                    for (let i = 0; i < arg; i++) {
+                        arr.push(readItem());
+                    }
+                }
+                return arr;
+            }
+            case 5: {
+                const obj = {};
+                if (arg < 0) {
+                    while (bytes[pos] !== 0xff) {
+                        const key = readItem();
+                        obj[key] = readItem();
+                    }
+                    pos++;
+                }
+                else {
+                    for (let i = 0; i < arg; i++) {
+                        const key = readItem();
+                        obj[key] = readItem();
+                    }
+                }
+                return obj;
+            }
+            case 6: return readItem(); // tags carry no meaning for the dashboard
+        }
+        throw new Error(`CBOR: bad major type ${major}`);
+    }
+
+    return readItem();
+}
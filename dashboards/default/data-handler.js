@@ -408,10 +408,107 @@ function waHideAuth() {
     document.getElementById('wa-auth-err').textContent = '';
 }
 
-function waBuildWsUrl(secret) {
+function waBuildWsUrl(secret, deflate) {
     const proto = (location.protocol === 'https:') ? 'wss' : 'ws';
     const host = location.hostname;
-    return `${proto}://${host}:3004/?key=${encodeURIComponent(secret)}`;
+    // delta=1: changed modules arrive as JSON merge patches (RFC 7386)
+    // compress=deflate: large frames arrive deflated (see createFrameInflater)
+    const compress = deflate ? '&compress=deflate' : '';
+    return `${proto}://${host}:3004/?key=${encodeURIComponent(secret)}&delta=1${compress}`;
+}
+
+function waSupportsDeflate() {
+    try {
+        new DecompressionStream('deflate-raw');
+        return true;
+    }
+    catch (e) {
+        return false;
+    }
+}
+
+// Compressed frame: 0xFF, uint32 (big endian) inflated length, raw deflate data.
+// The server keeps one deflate stream per connection, so frames must be inflated
+// by one stream, in order.
+function createFrameInflater() {
+    const stream = new DecompressionStream('deflate-raw');
+    const writer = stream.writable.getWriter();
+    const reader = stream.readable.getReader();
+    return async (frame) => {
+        const length = new DataView(frame.buffer, frame.byteOffset, frame.byteLength).getUint32(1);
+        writer.write(frame.subarray(5)).catch(() => {});
+        const out = new Uint8Array(length);
+        let filled = 0;
+        while (filled < length) {
+            const { value, done } = await reader.read();
+            if (done) {
+                throw new Error('inflate stream ended');
+            }
+            out.set(value, filled);
+            filled += value.length;
+        }
+        return out;
+    };
+}
+
+// Server frame -> message object: JSON text, CBOR, or either of them deflated.
+async function decodeFrame(socket, raw, inflate) {
+    if (typeof raw === 'string') {
+        return JSON.parse(raw);
+    }
+    let bytes = new Uint8Array(raw);
+    if (bytes[0] === 0xff && inflate) {
+        bytes = await inflate(bytes);
+        if (socket.protocol !== 'winagent.cbor') {
+            return JSON.parse(new TextDecoder().decode(bytes));
+        }
+    }
+    return cborDecode(bytes.buffer.slice(bytes.byteOffset, bytes.byteOffset + bytes.byteLength));
+}
+
+// Last full state of every module; updates patch it.
+let moduleState = {};
+
+function applyMergePatch(target, patch) {
+    if (patch === null || typeof patch !== 'object' || Array.isArray(patch)) {
+        return patch;
+    }
+    const out = (target !== null && typeof target === 'object' && !Array.isArray(target)) ? { ...target } : {};
+    for (const [k, v] of Object.entries(patch)) {
+        if (v === null) {
+            delete out[k];
+        }
+        else {
+            out[k] = applyMergePatch(out[k], v);
+        }
+    }
+    return out;
+}
+
+// Full snapshots of the modules in this update (patches applied), or null when
+// a patch refers to a module we do not have and a keyframe was requested.
+function mergeUpdate(payload) {
+    if (payload.keyframe) {
+        moduleState = {};
+    }
+    const modules = {};
+    for (const [id, value] of Object.entries(payload.modules || {})) {
+        moduleState[id] = value;
+        modules[id] = value;
+    }
+    for (const [id, patch] of Object.entries(payload.patch || {})) {
+        if (!(id in moduleState)) {
+            ws.send(JSON.stringify({ event: 'resync' }));
+            return null;
+        }
+        moduleState[id] = applyMergePatch(moduleState[id], patch);
+        modules[id] = moduleState[id];
+    }
+    // Stopped or unloaded on the server: it comes back in full if it returns.
+    for (const id of payload.removed || []) {
+        delete moduleState[id];
+    }
+    return modules;
 }
 
 let ws;
@@ -452,11 +549,24 @@ function connect() {
 
     waHideAuth();
 
-    const wsUrl = waBuildWsUrl(secret);
-    ws = new WebSocket(wsUrl);
+    const deflate = waSupportsDeflate();
+    const wsUrl = waBuildWsUrl(secret, deflate);
+    // Binary CBOR frames when the server speaks it, JSON text otherwise.
+    const socket = new WebSocket(wsUrl, ['winagent.cbor', 'winagent.json']);
+    socket.binaryType = 'arraybuffer';
+    ws = socket;
+    const inflate = deflate ? createFrameInflater() : null;
+    let received = Promise.resolve();
 
     ws.onopen = () => {
         console.log('Connected to server');
+        moduleState = {};
+        // Only what this page renders (the server's "host" module is not shown here).
+        ws.send(JSON.stringify({
+            event: 'subscribe',
+            modules: ['basiccpu', 'basicmemory', 'basicnetwork', 'volumemixer', 'audiodevices',
+                      'audezemaxwell', 'media', 'launcher'],
+        }));
         document.getElementById('wa-auth').style.display = 'none';
         // ws.send(JSON.stringify({ cmd: "runAction", payload: { action: 1} }));
     };
@@ -479,48 +589,62 @@ function connect() {
     ws.onmessage = (e) => {
         // console.log('RAW DATA:', e.data);
         dataReceived();
-        const data = JSON.parse(e.data);
-        const event = data.event;
-        const payload = data.payload;
-        if (event === 'update') {
-            console.log('UPDATE EVENT:', payload);
-            if ('basiccpu' in payload.modules) {
-                updateCPU(payload.modules.basiccpu);
-            }
-            if ('basicmemory' in payload.modules) {
-                updateRAM(payload.modules.basicmemory);
-            }
-            if ('basicnetwork' in payload.modules) {
-                updateNet(payload.modules.basicnetwork);
-            }
-            if ('volumemixer' in payload.modules) {
-                updateAudioApps(payload.modules.volumemixer);
-            }
-            if ('audiodevices' in payload.modules) {
-                if (isModuleLocked('audiodevices')) {
-                    return;
-                }
-                updateAudioDevices(payload.modules.audiodevices);
-            }
-            if ('audezemaxwell' in payload.modules) {
-                updateAudioAudeze(payload.modules.audezemaxwell);
-            }
-            if ('media' in payload.modules) {
-                updateMedia(payload.modules.media);
-            }
-            if ('launcher' in payload.modules) {
-                generateHash(payload.modules.launcher).then(hash => {
-                    if (hash !== window.launcherHash) {
-                        updateLauncherActions(payload.modules.launcher);
-                        window.launcherHash = hash;
-                    }
-                });
+        // Inflating is asynchronous: keep the frames in arrival order.
+        received = received
+            .then(() => decodeFrame(socket, e.data, inflate))
+            .then(onServerMessage)
+            .catch(err => {
+                console.error('Bad frame from server, reconnecting: ', err);
+                socket.close();
+            });
+    };
+}
+
+function onServerMessage(data) {
+    const event = data.event;
+    const payload = data.payload;
+    if (event === 'update') {
+        console.log('UPDATE EVENT:', payload);
+        const modules = mergeUpdate(payload);
+        if (!modules) {
+            return;
+        }
+        if ('basiccpu' in modules) {
+            updateCPU(modules.basiccpu);
+        }
+        if ('basicmemory' in modules) {
+            updateRAM(modules.basicmemory);
+        }
+        if ('basicnetwork' in modules) {
+            updateNet(modules.basicnetwork);
+        }
+        if ('volumemixer' in modules) {
+            updateAudioApps(modules.volumemixer);
+        }
+        if ('audiodevices' in modules) {
+            if (isModuleLocked('audiodevices')) {
+                return;
             }
+            updateAudioDevices(modules.audiodevices);
         }
-        else if (event === 'launcher_icon_update') {
-            onLauncherIconResponse(data);
+        if ('audezemaxwell' in modules) {
+            updateAudioAudeze(modules.audezemaxwell);
         }
-    };
+        if ('media' in modules) {
+            updateMedia(modules.media);
+        }
+        if ('launcher' in modules) {
+            generateHash(modules.launcher).then(hash => {
+                if (hash !== window.launcherHash) {
+                    updateLauncherActions(modules.launcher);
+                    window.launcherHash = hash;
+                }
+            });
+        }
+    }
+    else if (event === 'launcher_icon_update') {
+        onLauncherIconResponse(data);
+    }
 }
 
 document.addEventListener('DOMContentLoaded', () => {
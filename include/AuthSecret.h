@@ -0,0 +1,16 @@
+#pragma once
+
+#include <QString>
+
+// Dashboard auth key: six digits kept in %USER_HOME%/winagent.secret.
+// Shared by the tray app and the headless daemon so both accept the same key.
+namespace AuthSecret {
+    QString path();
+
+    QString generate();
+
+    bool write(const QString &s);
+
+    // Existing valid key, or a freshly generated one (written back to path()).
+    QString loadOrCreate();
+}
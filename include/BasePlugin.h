@@ -2,9 +2,15 @@
 
 #include <cstdint>
 #include <atomic>
+#include <chrono>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <condition_variable>
+#include <deque>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
 #include <QString>
 #include <QByteArray>
@@ -15,6 +21,12 @@
 // =========================
 static constexpr uint32_t WA_PLUGIN_API_VERSION = 1;
 
+// Encoding of a handle's views (wa_get_view_format).
+enum WaFormat : uint32_t {
+    WA_FMT_JSON = 0,   // UTF-8 JSON object text
+    WA_FMT_CBOR = 1,   // CBOR map (RFC 8949), as written by QCborValue::toCbor()
+};
+
 struct WaView {
     const char* ptr;
     uint32_t    len;
@@ -28,6 +40,47 @@ struct WaPluginInfo {
     uint32_t    defaultIntervalMs; // plugin default sampling interval
 };
 
+// Tick timing statistics (wa_get_tick_stats).
+// Histogram bucket 0 counts samples < 64 us, bucket i counts [32 << i, 64 << i) us,
+// the last bucket is open-ended (>= ~1 s).
+static constexpr uint32_t WA_TICK_HIST_BUCKETS = 16;
+
+struct WaTickStats {
+    uint64_t ticks;        // completed onTick() calls
+    uint64_t overruns;     // ticks that ended after the next deadline
+    uint64_t skipped;      // deadlines dropped by the overrun policy
+    uint64_t lastTickUs;   // duration of the last onTick()
+    uint64_t maxTickUs;
+    uint64_t maxJitterUs;  // worst wake-up delay past the deadline
+    uint64_t tickUsHist[WA_TICK_HIST_BUCKETS];
+    uint64_t jitterUsHist[WA_TICK_HIST_BUCKETS];
+};
+
+// Resource cost of one handle (wa_get_cost_stats), totals since wa_create.
+// CPU time is the tick thread's user + kernel time; on Windows it advances in
+// scheduler quanta (~15.6 ms), so single ticks read coarse but totals are exact.
+enum WaCostFlags : uint32_t {
+    WA_COST_ALLOCS = 1u << 0,  // allocs/allocBytes are counted (plugin built with WA_COUNT_ALLOCS)
+};
+
+struct WaCostStats {
+    uint32_t flags;           // WaCostFlags
+    uint32_t reserved;
+    uint64_t tickCpuUs;       // CPU time spent in ticks
+    uint64_t lastTickCpuUs;
+    uint64_t maxTickCpuUs;
+    uint64_t allocs;          // heap allocations made by ticks
+    uint64_t allocBytes;
+    uint64_t lastTickAllocs;
+};
+
+// Consumer demand bits (wa_set_demand / WaHostApi::demand_get).
+enum WaDemand : uint32_t {
+    WA_DEMAND_CLIENTS    = 1u << 0,  // at least one dashboard client is connected
+    WA_DEMAND_SUBSCRIBED = 1u << 1,  // a connected client receives this module
+    WA_DEMAND_GUI        = 1u << 2,  // the host window is visible
+};
+
 enum WaRc : int32_t {
     WA_OK = 0,
     WA_ERR = 1,
@@ -44,13 +97,17 @@ enum WaRc : int32_t {
   #endif
 #else
   #define WA_CALL
-  #define WA_EXPORT extern "C"
+  #if defined(WA_BUILDING_PLUGIN)
+    #define WA_EXPORT extern "C" __attribute__((visibility("default")))
+  #else
+    #define WA_EXPORT extern "C"
+  #endif
 #endif
 
 // =========================
 // Optional Host API (plugin -> host)
 // =========================
-static constexpr uint32_t WA_HOST_API_VERSION = 1;
+static constexpr uint32_t WA_HOST_API_VERSION = 4;
 
 enum WaPluginState : int32_t {
     WA_STATE_MISSING = -1,
@@ -60,6 +117,8 @@ enum WaPluginState : int32_t {
     WA_STATE_ERROR   = 3,
 };
 
+typedef void (WA_CALL *WaTaskFn)(void* taskUser);
+
 struct WaHostApi {
     uint32_t apiVersion;
     void*    user;
@@ -67,7 +126,32 @@ struct WaHostApi {
     int32_t (WA_CALL *plugin_get_state)(void* user, const char* pluginIdUtf8);
     int32_t (WA_CALL *plugin_start)(void* user, const char* pluginIdUtf8);
     int32_t (WA_CALL *plugin_stop)(void* user, const char* pluginIdUtf8);
+    // Queued on the host's control thread: returns WA_OK once accepted
+    // (WA_ERR_BAD_ARG for an unknown id), before the new handle runs.
     int32_t (WA_CALL *plugin_restart)(void* user, const char* pluginIdUtf8);
+
+    // ---- apiVersion >= 2: shared tick scheduler ----
+    // A registered task runs every intervalMs on a host worker pool, never
+    // concurrently with itself. sched_unregister blocks until a running call
+    // returns, so it must not be called from inside the task.
+    uint64_t (WA_CALL *sched_register)(void* user, WaTaskFn fn, void* taskUser, uint32_t intervalMs);
+    void     (WA_CALL *sched_unregister)(void* user, uint64_t taskId);
+    void     (WA_CALL *sched_set_interval)(void* user, uint64_t taskId, uint32_t intervalMs);
+    void     (WA_CALL *sched_set_active)(void* user, uint64_t taskId, int32_t active);
+    // One extra run as soon as possible (also for an inactive task); the regular
+    // schedule is unchanged.
+    void     (WA_CALL *sched_wake)(void* user, uint64_t taskId);
+
+    // ---- apiVersion >= 3: consumer demand ----
+    // Current WaDemand bits for a plugin. Changes are pushed through wa_set_demand.
+    uint32_t (WA_CALL *demand_get)(void* user, const char* pluginIdUtf8);
+
+    // ---- apiVersion >= 4: live reconfiguration ----
+    // Re-reads the plugin's config.json and applies it through wa_configure, falling
+    // back to plugin_restart when the plugin cannot apply it live. Queued: returns
+    // WA_OK once accepted (WA_ERR_BAD_ARG for an unknown id) and the host applies it
+    // on its control thread, so a UI's Save button never waits on a tick.
+    int32_t (WA_CALL *plugin_reconfigure)(void* user, const char* pluginIdUtf8);
 };
 
 // Required exports:
@@ -84,12 +168,141 @@ WA_EXPORT void    WA_CALL wa_destroy(void* handle);
 WA_EXPORT WaView  WA_CALL wa_request(void* handle, const char* requestJsonUtf8);
 WA_EXPORT WaView  WA_CALL wa_read(void* handle);
 
+// Optional exports:
+// Returns an empty view ({nullptr, 0}) when the snapshot generation still equals
+// lastSeenGeneration; otherwise the snapshot (same lifetime as wa_read) and its
+// generation in *generationOut. Generations start at 1 and only grow per handle.
+WA_EXPORT WaView  WA_CALL wa_read_if_changed(void* handle, uint64_t lastSeenGeneration, uint64_t* generationOut);
+
+// Copies the plugin's tick duration / wake jitter statistics into *out.
+WA_EXPORT int32_t WA_CALL wa_get_tick_stats(void* handle, WaTickStats* out);
+
+// Copies the plugin's CPU time / allocation totals into *out.
+WA_EXPORT int32_t WA_CALL wa_get_cost_stats(void* handle, WaCostStats* out);
+
+// WaFormat of every view the handle returns (wa_read, wa_read_if_changed, wa_request
+// and async responses). Fixed for the handle's lifetime; without this export, JSON.
+WA_EXPORT uint32_t WA_CALL wa_get_view_format(void* handle);
+
+// Called by the host whenever the plugin's WaDemand bits change (and once before
+// wa_start). Plugins may slow down or stop sampling while nobody consumes them.
+WA_EXPORT void    WA_CALL wa_set_demand(void* handle, uint32_t demandFlags);
+
+// Completion for wa_request_async. The response view is only valid during the call.
+typedef void (WA_CALL *WaRequestDoneFn)(void* doneUser, uint64_t requestId, WaView response);
+
+// Queues a request and returns immediately. On WA_OK, done is called exactly once
+// (from any thread, possibly before this returns), and always before wa_stop()
+// returns. On error, done is never called.
+WA_EXPORT int32_t WA_CALL wa_request_async(void* handle, const char* requestJsonUtf8,
+                                           uint64_t requestId, WaRequestDoneFn done, void* doneUser);
+
+// Completion for wa_tick_now: generation of the first snapshot published by a tick
+// that started after the call, or 0 if the plugin stopped first.
+typedef void (WA_CALL *WaTickDoneFn)(void* doneUser, uint64_t generation);
+
+// Runs one extra tick as soon as possible (e.g. after a state-changing request) without
+// moving the regular schedule. WA_ERR_BAD_STATE unless running. On WA_OK a non-null
+// done is called exactly once, from any thread, and always before wa_stop() returns.
+WA_EXPORT int32_t WA_CALL wa_tick_now(void* handle, WaTickDoneFn done, void* doneUser);
+
+// Applies a changed config (same JSON as wa_create) to a live handle, keeping its warm
+// state. WA_OK: in effect from the next tick. WA_ERR_BAD_STATE: the change needs a
+// restart (the host then recreates the plugin). WA_ERR_BAD_ARG: not a JSON object.
+WA_EXPORT int32_t WA_CALL wa_configure(void* handle, const char* configJsonUtf8);
+
+// =========================
+// C++ SnapshotWriter
+// =========================
+// Append-only encoder used by BasePlugin::onTickWrite(). Writes JSON or CBOR
+// (indefinite-length maps/arrays) straight into a buffer whose capacity is kept
+// between ticks, so a steady snapshot shape costs no heap allocations.
+//
+//   w.beginObject();
+//   w.field("ok", true);
+//   w.key("items").beginArray();
+//   for (...) w.beginObject().field("name", name).field("value", v).endObject();
+//   w.endArray();
+//   w.endObject();
+//
+// Keys and std::string_view values are UTF-8; std::wstring_view values are
+// UTF-16 (Windows wchar_t) and converted on the fly.
+class SnapshotWriter {
+public:
+    SnapshotWriter& beginObject();
+    SnapshotWriter& endObject();
+    SnapshotWriter& beginArray();
+    SnapshotWriter& endArray();
+
+    SnapshotWriter& key(std::string_view utf8);
+
+    SnapshotWriter& null();
+    SnapshotWriter& value(std::string_view utf8);
+    SnapshotWriter& value(const char* utf8) { return value(std::string_view(utf8 ? utf8 : "")); }
+    SnapshotWriter& value(std::wstring_view text);
+    SnapshotWriter& value(const QString& text);
+
+    // bool, integers, enums and floating point
+    template <typename T>
+    std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>, SnapshotWriter&> value(T v) {
+        if constexpr (std::is_enum_v<T>) {
+            return value(static_cast<std::underlying_type_t<T>>(v));
+        } else if constexpr (std::is_same_v<T, bool>) {
+            return writeBool(v);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            return writeDouble(static_cast<double>(v));
+        } else if constexpr (std::is_signed_v<T>) {
+            return writeInt(static_cast<int64_t>(v));
+        } else {
+            return writeUInt(static_cast<uint64_t>(v));
+        }
+    }
+
+    template <typename T>
+    SnapshotWriter& field(std::string_view k, T&& v) { return key(k).value(std::forward<T>(v)); }
+
+    WaFormat format() const noexcept { return format_; }
+
+private:
+    friend class BasePlugin;
+    static constexpr int kMaxDepth = 32;
+
+    // Starts a new document in *out (keeps its capacity).
+    void reset(QByteArray* out, WaFormat format);
+    // True when every container was closed and exactly one root value was written.
+    bool finish() const { return ok_ && depth_ == 0 && rootDone_; }
+
+    SnapshotWriter& writeBool(bool v);
+    SnapshotWriter& writeInt(int64_t v);
+    SnapshotWriter& writeUInt(uint64_t v);
+    SnapshotWriter& writeDouble(double v);
+
+    bool beforeValue();
+    void beginContainer(char jsonOpen, uint8_t cborOpen);
+    void endContainer(char jsonClose);
+    void cborHead(uint8_t major, uint64_t arg);
+    void jsonString(std::string_view utf8);
+    void jsonEscaped(char c);
+    template <typename CharT>
+    void unicodeString(const CharT* s, size_t n);
+
+    QByteArray* out_ = nullptr;
+    WaFormat format_ = WA_FMT_JSON;
+    int  depth_ = 0;
+    bool ok_ = true;
+    bool rootDone_ = false;
+    bool afterKey_ = false;
+    bool needComma_[kMaxDepth + 1]{};
+    bool isObject_[kMaxDepth + 1]{};
+};
+
 // =========================
 // C++ BasePlugin
 // =========================
 class BasePlugin {
 public:
-    explicit BasePlugin(uint32_t defaultIntervalMs, const char* configJsonUtf8 = nullptr);
+    // host: the WaHostApi passed as hostCtx to wa_create (optional).
+    explicit BasePlugin(uint32_t defaultIntervalMs, const char* configJsonUtf8 = nullptr, WaHostApi* host = nullptr);
     virtual ~BasePlugin();
 
     int32_t init();
@@ -98,16 +311,70 @@ public:
     int32_t resume();
     int32_t stop();
 
-    // Host-facing views (stable until next call of same function for this handle)
+    // Host-facing views (stable until next call of same function for this handle).
+    // readView() never blocks the worker: it pins the currently published snapshot.
     WaView readView();
+    WaView readViewIfChanged(uint64_t lastSeenGeneration, uint64_t* generationOut);
     WaView requestView(const char* requestJsonUtf8);
+    // Answers on the plugin's request thread (started on first use), so a slow
+    // onRequest() never blocks the host caller.
+    int32_t requestAsync(const char* requestJsonUtf8, uint64_t requestId, WaRequestDoneFn done, void* doneUser);
+
+    // Wakes the tick thread for one extra tick (wa_tick_now). Plugins may also call
+    // this from onRequest() after changing state. done (optional) runs once the
+    // fresh snapshot is published.
+    int32_t requestImmediateTick(WaTickDoneFn done = nullptr, void* doneUser = nullptr);
+
+    // wa_configure: hands the new config to the tick thread and waits until it is
+    // applied. "intervalMs", "overrunPolicy", "idle" and "idleIntervalMs" are handled
+    // here; other changed keys go through onReconfigure(). "sharedScheduler",
+    // "requestsOnWorker" and "snapshotFormat" are fixed for the handle's lifetime.
+    int32_t configure(const char* configJsonUtf8);
+
+    // Generation of the currently published snapshot (bumped on every publish)
+    uint64_t snapshotGeneration() const noexcept;
 
     uint32_t intervalMs() const noexcept { return intervalMs_.load(); }
     void setIntervalMs(uint32_t ms);
 
-    // Parsed config object (from configJsonUtf8 passed to ctor)
+    // What to do when a tick ends after the next deadline ("overrunPolicy" in config):
+    // - Skip:    drop the missed deadlines and stay on the original grid (default)
+    // - CatchUp: run the missed ticks back to back (bounded burst)
+    // - Stretch: start a new period from the end of the slow tick
+    enum class OverrunPolicy { Skip, CatchUp, Stretch };
+    OverrunPolicy overrunPolicy() const noexcept { return overrunPolicy_.load(); }
+
+    int32_t tickStats(WaTickStats* out) const;
+    int32_t costStats(WaCostStats* out) const;
+
+    // What to do while no consumer wants the data ("idle" in config):
+    // - Park: stop ticking until demand returns (default)
+    // - Slow: tick every "idleIntervalMs" instead
+    // - Off:  ignore demand
+    enum class IdlePolicy { Park, Slow, Off };
+
+    // Host-pushed WaDemand bits (wa_set_demand). Without a host that reports
+    // demand, the plugin always behaves as watched.
+    void setDemand(uint32_t demandFlags);
+    uint32_t demand() const noexcept { return demand_.load(); }
+    bool idle() const noexcept;
+
+    // Parsed config object (from configJsonUtf8 passed to ctor). configure() replaces
+    // it between two ticks, so read it from onInit()/onTick()/onReconfigure().
     const QJsonObject& config() const noexcept { return config_; }
 
+    // Encoding of snapshots and replies ("snapshotFormat": "json" | "cbor" in config),
+    // reported through wa_get_view_format. Fixed for the handle's lifetime.
+    WaFormat viewFormat() const noexcept { return format_; }
+
+    // True when onRequest() runs on the tick thread between ticks ("requestsOnWorker": true).
+    // Requests are then never concurrent with onTick(); wa_request blocks on the reply.
+    bool requestsOnWorker() const noexcept { return requestsOnWorker_; }
+
+    // True when ticks run on the host's shared scheduler instead of an own thread.
+    // Opt in with "sharedScheduler": true in config.json (needs host API v2).
+    bool usesHostScheduler() const noexcept { return useHostScheduler_; }
+
 protected:
     // Implement in plugin:
     virtual bool onInit(QString& err) { Q_UNUSED(err); return true; }
@@ -116,14 +383,56 @@ protected:
     // Return JSON payload as object (BasePlugin serializes Compact UTF-8)
     virtual QJsonObject onTick() = 0;
 
-    // Synchronous request handler (already parsed JSON object)
+    // Streaming alternative to onTick(): write the snapshot (one root object)
+    // into w and return true. Returning false falls back to onTick().
+    // Plugins that only stream derive from StreamingPlugin instead.
+    virtual bool onTickWrite(SnapshotWriter& w) { Q_UNUSED(w); return false; }
+
+    // Request handler (already parsed JSON object). Runs on the host caller's thread
+    // for wa_request and on the plugin's request thread for wa_request_async, or on
+    // the tick thread with "requestsOnWorker".
     virtual QJsonObject onRequest(const QJsonObject& req);
 
+    // "requestsOnWorker" only: requests with the same non-empty key that are queued
+    // between two ticks are coalesced; only the last one runs and all of them get its reply.
+    virtual QString coalesceKey(const QJsonObject& req) const { Q_UNUSED(req); return {}; }
+
+    // Live config change (wa_configure): cfg is the complete new config; config()
+    // still returns the old one. Runs on the tick thread between ticks. Return false
+    // when the change needs a restart (the default).
+    virtual bool onReconfigure(const QJsonObject& cfg) { Q_UNUSED(cfg); return false; }
+
 private:
     enum class State { Constructed, Inited, Running, Paused, Stopped };
 
+    using Clock = std::chrono::steady_clock;
+
     void threadMain();
+    // onGrid == false: extra tick ahead of the deadline, the schedule stays as is.
+    bool tickOnce(bool onGrid = true);   // true when the next tick is already due (catch-up)
+    void finishTickWaiters(uint64_t generation);
+    bool advanceDeadline(Clock::time_point now);
+    bool parked() const noexcept { return idlePolicy_ == IdlePolicy::Park && idle(); }
+    uint32_t effectiveIntervalMs() const noexcept;
+    void updateSchedActive();
+    static void WA_CALL schedTick(void* self);
     void setSnapshotObject(const QJsonObject& obj);
+    WaView emptyView() const noexcept;
+    bool publishStreamed();
+    void applyBaseConfig(const QJsonObject& cfg);
+    int32_t applyConfig(const QJsonObject& cfg);
+    void applyPendingConfig();
+    struct QueuedRequest;
+    QJsonObject handleRequest(const char* jsonUtf8);
+    static QueuedRequest* queueClosed();
+    bool hasQueuedRequests() const noexcept;
+    bool pushRequest(QueuedRequest* r);
+    void drainRequests();
+    void closeRequestQueue();
+    void completeRequest(QueuedRequest* r, const QJsonObject& resp) const;
+    void requestThreadMain();
+    void stopRequestThread();
+    QByteArray encodeObject(const QJsonObject& obj) const;
     static QJsonObject parseObjectUtf8(const char* jsonUtf8, QString* errOut);
 
     std::atomic<State> state_{State::Constructed};
@@ -134,12 +443,159 @@ private:
     std::mutex  cvMu_;
     std::condition_variable cv_;
 
+    // Fixed-rate schedule: ticks start at deadline_, deadline_ += interval.
+    // Only touched by the thread running the ticks.
+    Clock::time_point deadline_{};
+    std::atomic<bool> resyncDeadline_{true};
+    std::atomic<OverrunPolicy> overrunPolicy_{OverrunPolicy::Skip};
+    uint32_t defaultIntervalMs_ = 1000;
+
+    struct TickCounters {
+        std::atomic<uint64_t> ticks{0};
+        std::atomic<uint64_t> overruns{0};
+        std::atomic<uint64_t> skipped{0};
+        std::atomic<uint64_t> lastTickUs{0};
+        std::atomic<uint64_t> maxTickUs{0};
+        std::atomic<uint64_t> maxJitterUs{0};
+        std::atomic<uint64_t> tickUsHist[WA_TICK_HIST_BUCKETS]{};
+        std::atomic<uint64_t> jitterUsHist[WA_TICK_HIST_BUCKETS]{};
+
+        // wa_get_cost_stats
+        std::atomic<uint64_t> tickCpuUs{0};
+        std::atomic<uint64_t> lastTickCpuUs{0};
+        std::atomic<uint64_t> maxTickCpuUs{0};
+        std::atomic<uint64_t> allocs{0};
+        std::atomic<uint64_t> allocBytes{0};
+        std::atomic<uint64_t> lastTickAllocs{0};
+    } stats_;
+
+    // requestImmediateTick: waiters are taken by the next tick that starts and
+    // completed once it has published.
+    struct TickWaiter {
+        WaTickDoneFn done = nullptr;
+        void* doneUser = nullptr;
+    };
+    std::atomic<bool> tickNow_{false};
+    std::mutex tickWaitMu_;
+    std::vector<TickWaiter> tickWaiters_;
+    std::vector<TickWaiter> tickFiring_;  // tick thread only
+
+    // Consumer demand (see setDemand)
+    std::atomic<uint32_t> demand_{WA_DEMAND_CLIENTS | WA_DEMAND_SUBSCRIBED | WA_DEMAND_GUI};
+    std::atomic<IdlePolicy> idlePolicy_{IdlePolicy::Park};
+    std::atomic<uint32_t>   idleIntervalMs_{10000};
+    std::mutex demandMu_;  // orders scheduler (de)activation between demand, pause and ticks
+
+    // Shared scheduler mode (host-owned worker pool)
+    WaHostApi* host_ = nullptr;
+    bool       useHostScheduler_ = false;
+    // Written by start()/stop(), read from any thread (demand, wakes, configure):
+    // load it once per use. Task ids are never reused, so a stale id is a no-op.
+    std::atomic<uint64_t> schedTask_{0};
+
     // JSON config
     QJsonObject config_{};
+    WaFormat format_ = WA_FMT_JSON;
+
+    // wa_configure hand-off: published under tickWaitMu_ (like tick waiters) and
+    // taken by the tick thread, or by stop() once that thread is gone.
+    struct PendingConfig;
+    std::mutex configMu_;  // one configure() at a time
+    std::atomic<PendingConfig*> pendingConfig_{nullptr};
+
+    // Immutable snapshot published by the worker (RCU-style).
+    // Readers pin the current one; the old buffer is freed when the last pin drops.
+    struct Snapshot {
+        QByteArray bytes;
+        uint64_t generation = 0;
+    };
+    using SnapshotPtr = std::shared_ptr<const Snapshot>;
+
+    // Streaming path: snapshots are handed back instead of freed. Whichever thread
+    // drops the last reference (usually the host's read thread, when readPin_ moves
+    // on) passes the snapshot to recycled_ under recycleMu_, and the tick thread only
+    // rewrites what it takes from there. Control blocks are recycled the same way,
+    // so buffers and shared_ptr bookkeeping survive across ticks.
+    struct SnapshotRecycler {
+        BasePlugin* owner;
+        void operator()(Snapshot* snap) const noexcept { owner->recycleSnapshot(snap); }
+    };
+    template <class T>
+    struct ControlBlockAlloc {
+        using value_type = T;
+        BasePlugin* owner;
+        explicit ControlBlockAlloc(BasePlugin* o) noexcept : owner(o) {}
+        template <class U>
+        ControlBlockAlloc(const ControlBlockAlloc<U>& o) noexcept : owner(o.owner) {}
+        T* allocate(size_t n) { return static_cast<T*>(owner->allocControlBlock(n * sizeof(T))); }
+        void deallocate(T* p, size_t n) noexcept { owner->freeControlBlock(p, n * sizeof(T)); }
+        template <class U>
+        bool operator==(const ControlBlockAlloc<U>& o) const noexcept { return owner == o.owner; }
+    };
+    std::shared_ptr<Snapshot> takeRecycledSnapshot();
+    void recycleSnapshot(Snapshot* snap) noexcept;
+    void* allocControlBlock(size_t bytes);
+    void freeControlBlock(void* block, size_t bytes) noexcept;
+    static constexpr size_t kMaxSpareSnapshots = 4;
+
+    // Declared before latest_/readPin_: their last references come back here on destruction.
+    struct BlockCache {
+        size_t bytes = 0;
+        std::vector<void*> blocks;
+        ~BlockCache();
+    };
+    std::mutex recycleMu_;
+    std::vector<std::unique_ptr<Snapshot>> recycled_;  // recycleMu_
+    BlockCache freeBlocks_;                            // recycleMu_
+
+    SnapshotWriter writer_;
+
+    std::atomic<SnapshotPtr> latest_;
+    std::atomic<uint64_t> nextGeneration_{1};
+    SnapshotPtr readPin_;   // keeps the last wa_read() view alive (host read thread only)
 
-    // Snapshot / reply buffers
-    std::mutex snapMu_;
-    QByteArray latest_;
-    QByteArray readBuf_;
+    // Reply buffer for wa_request()
+    std::mutex replyMu_;
     QByteArray replyBuf_;
+
+    // wa_request_async queue, served in order by requestThread_
+    struct AsyncRequest {
+        QByteArray json;
+        uint64_t id = 0;
+        WaRequestDoneFn done = nullptr;
+        void* doneUser = nullptr;
+    };
+    std::thread requestThread_;
+    std::mutex requestMu_;
+    std::condition_variable requestCv_;
+    std::deque<AsyncRequest> requests_;
+    bool requestsClosed_ = false;
+
+    // "requestsOnWorker": lock-free MPSC stack (producers CAS-push, the tick
+    // thread takes the whole batch). Starts and ends closed, see queueClosed().
+    bool requestsOnWorker_ = false;
+    std::atomic<QueuedRequest*> reqHead_;
+    std::atomic<bool> requestWake_{false};  // shared scheduler: run was a request wake
+
+    struct BatchItem {
+        QueuedRequest* r = nullptr;
+        QJsonObject req;
+        QString parseError;
+        QJsonObject reply;
+        size_t answerFrom = 0;  // index whose reply this request gets (coalescing)
+    };
+    std::vector<BatchItem> batch_;  // tick thread only; keeps its capacity
+};
+
+// Base for plugins that only stream their snapshots: onTickWrite() must be
+// implemented, and a false return publishes { "ok": false, "error": "no_snapshot" }.
+class StreamingPlugin : public BasePlugin {
+public:
+    using BasePlugin::BasePlugin;
+
+protected:
+    bool onTickWrite(SnapshotWriter& w) override = 0;
+
+private:
+    QJsonObject onTick() final { return QJsonObject{{"ok", false}, {"error", "no_snapshot"}}; }
 };
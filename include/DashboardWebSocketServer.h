@@ -2,12 +2,23 @@
 
 #include <QWebSocketServer>
 #include <QWebSocket>
+#include <QHash>
+#include <QJsonObject>
 #include <QSet>
 
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "FrameDeflater.h"
+#include "PluginManager.h"
+
 class LauncherMonitor;
 class AudioMonitor;
 class MediaMonitor;
-class PluginManager;
 
 // Module Ids
 enum ModuleId : uint8_t {
@@ -86,18 +97,159 @@ private slots:
 
     void onTextMessageReceived(const QString &message);
 
+    void onBinaryMessageReceived(const QByteArray &message);
+
     void broadcastTick(); // 500ms callback
 
 private:
     QSet<QWebSocket *> m_clients;
     QTimer *m_broadcastTimer = nullptr;
 
+    // Wire encoding, negotiated through the WebSocket subprotocol: clients offering
+    // kCborSubprotocol get binary CBOR frames, everyone else JSON text.
+    enum class Encoding { Json, Cbor };
+    static constexpr const char *kCborSubprotocol = "winagent.cbor";
+    static constexpr const char *kJsonSubprotocol = "winagent.json";
+
+    // Clients connecting with ?compress=deflate get frames of kCompressMinBytes and
+    // more compressed (see sendFrame); smaller ones gain too little to be worth it.
+    static constexpr qsizetype kCompressMinBytes = 256;
+
+    // Backpressure: a client with more than kMaxQueuedBytes not yet written gets
+    // no new update until it drains, and while its queue does not empty, updates
+    // are spaced by its measured drain speed (at most kMaxHoldMs apart). Command
+    // responses are always queued.
+    static constexpr qint64 kMaxQueuedBytes = 64 * 1024;
+    static constexpr qint64 kMaxHoldMs = 10000;
+
+    // Broadcast rates (milliseconds). The timer runs at the fastest subscribed
+    // minIntervalMs; a client gets an update at least every kHeartbeatMs.
+    static constexpr qint64 kDefaultIntervalMs = 1000;
+    static constexpr qint64 kMinIntervalMs = 100;
+    static constexpr qint64 kMaxIntervalMs = 60000;
+    static constexpr qint64 kHeartbeatMs = 1000;
+
+    // One entry of a client's subscription (module id, or "*" for every module
+    // without an entry of its own). A module goes out at most every minIntervalMs;
+    // maxIntervalMs > 0 re-sends it unchanged at least that often.
+    struct Subscription {
+        qint64 minIntervalMs = kDefaultIntervalMs;
+        qint64 maxIntervalMs = 0;
+        qint64 lastAtMs = 0; // last broadcast this entry was due in
+        bool due = false;    // due in the running broadcast
+    };
+
+    // What each client holds. A WebSocket delivers in order or drops the
+    // connection, so a module version counts as acked once it is sent.
+    struct ClientState {
+        Encoding encoding = Encoding::Json;
+        std::shared_ptr<FrameDeflater> deflater; // set when the client asked for compression
+        bool mergePatch = false;          // connected with ?delta=1: changed modules as RFC 7386 patches
+        bool needsKeyframe = true;        // next update carries every subscribed module in full
+        QHash<QString, quint64> versions; // module id -> version the client has
+        QHash<QString, qint64> sentAtMs;  // module id -> when it last went out
+        qint64 lastMessageMs = 0;
+        QHash<QString, Subscription> subscriptions; // every module until the client subscribes
+
+        // Send queue accounting, sampled once per broadcast
+        qint64 sentBytes = 0;          // handed to the socket since the last sample
+        qint64 queuedBytes = 0;        // bytesToWrite() at the last sample
+        qint64 maxQueuedBytes = 0;
+        qint64 sampleAtMs = 0;
+        double drainBytesPerSec = 0;   // while the queue stays non-empty; 0 = keeps up
+        qint64 holdUntilMs = 0;        // the last update is still draining until then
+        quint64 updatesHeld = 0;       // broadcasts skipped for backpressure
+    };
+    QHash<QWebSocket *, ClientState> m_clientState;
+
+    // Broadcast side of a module: the version grows whenever its snapshot changes.
+    // The snapshot is kept in the encoding the plugin wrote; the other one is built
+    // on first use (empty until then). While a client takes patches, the last few
+    // versions are kept parsed to diff against.
+    struct ModuleState {
+        quint64 version = 0;
+        QByteArray json;
+        QByteArray cbor;
+        std::deque<std::pair<quint64, QJsonObject>> recent;
+    };
+    QHash<QString, ModuleState> m_moduleState;
+    quint64 m_moduleVersion = 0;  // last version handed out, across all modules
+    static constexpr size_t kPatchHistory = 4;
+
+    // Modules with a fresh command result: due for every subscriber in the next broadcast.
+    QSet<QString> m_urgent;
+
+    // A broadcast whose plugin reads are running (see broadcastJson): sent by
+    // sendBroadcast() once they are all in or the read deadline fires.
+    struct PendingBroadcast {
+        quint64 seq = 0;
+        std::shared_ptr<PluginManager::ReadBatch> read;
+        qint64 nowMs = 0;
+        qint64 slackMs = 0;
+        QSet<QString> urgent;
+        QHash<QWebSocket *, bool> clients; // clients at the start -> keyframe due
+    };
+    std::unique_ptr<PendingBroadcast> m_pending;
+    quint64 m_broadcastSeq = 0;
+    bool m_broadcastAgain = false; // requested while one was pending
+    void sendBroadcast(quint64 seq);
+
+    static Subscription *subscriptionFor(ClientState &client, const QString &module);
+    void handleSubscribe(QWebSocket *socket, const QJsonValue &modules);
+    // Broadcast timer rate and plugin demand from all clients' subscriptions.
+    void applySubscriptions();
+
     PluginManager *m_plugins;
 
+    // Plugin completions arrive on pool/plugin threads, where neither `this` nor a
+    // QPointer may be touched. They post back through postIfAlive(), which checks
+    // `alive` under `mu`; the destructor clears it there first, so no post can
+    // slip in after it and Qt drops what is still queued with the object.
+    struct Liveness {
+        std::mutex mu;
+        bool alive = true;
+    };
+    std::shared_ptr<Liveness> m_liveness = std::make_shared<Liveness>();
+    static void postIfAlive(const std::shared_ptr<Liveness> &liveness, DashboardWebSocketServer *server,
+                            std::function<void()> fn);
+
+    void handleMessage(QWebSocket *socket, const QJsonObject &root);
     void handleModuleRequest(const QJsonObject &data);
+    void onModuleResponse(const QString &module, const QJsonObject &res);
 
     void sendResponse(const QJsonObject &data);
 
+    // One frame to one client: bytes is the JSON text (UTF-8) or CBOR document;
+    // text caches its QString form for JSON clients between calls. Returns the
+    // bytes handed to the socket.
+    qint64 sendFrame(QWebSocket *socket, ClientState &client, const QByteArray &bytes, QString &text);
+
+    // Per-client queue depth and drain speed, published in the plugins' host module.
+    void publishQueueMetrics(qint64 nowMs);
+    qint64 m_metricsAtMs = 0;
+
+    // One module in an update: its snapshot, or a merge patch against the client's
+    // version, already in the client's encoding.
+    struct UpdatePart {
+        const QString *id;
+        QByteArray data;
+        bool patch = false;
+    };
+
+    // Update envelope around the encoded modules (JSON text or CBOR).
+    static QByteArray buildUpdate(qint64 timestamp, bool keyframe,
+                                  const std::vector<UpdatePart> &parts,
+                                  const QStringList &stale,
+                                  const QStringList &removed);
+    static QByteArray buildUpdateCbor(qint64 timestamp, bool keyframe,
+                                      const std::vector<UpdatePart> &parts,
+                                      const QStringList &stale,
+                                      const QStringList &removed);
+
+    // Merge patch from baseVersion to the module's current snapshot (empty when the
+    // content is the same); false when the full snapshot has to go out instead.
+    static bool modulePatch(const ModuleState &module, quint64 baseVersion, QJsonObject &patch);
+
     QString m_authKey;
 
 };
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <memory>
+
+#include <QByteArray>
+
+// FrameDeflater
+// -------------
+// Raw DEFLATE stream (RFC 1951) for one WebSocket client's compressed frames.
+// The compression context carries over from frame to frame: every frame ends
+// with a sync flush, so the client inflates each one as it arrives and repeated
+// keys and values only cost a back-reference after the first frame.
+//
+// Needs zlib in the build (WA_HAVE_ZLIB); without it available() is false.
+class FrameDeflater {
+public:
+    FrameDeflater();
+    ~FrameDeflater();
+
+    FrameDeflater(const FrameDeflater&) = delete;
+    FrameDeflater& operator=(const FrameDeflater&) = delete;
+
+    static bool available();
+
+    // Appends `in`, compressed and flushed, to `out`. Once this fails the stream
+    // is broken and the client has to start over with a new connection.
+    bool compress(const QByteArray& in, QByteArray& out);
+
+private:
+    struct Stream;
+    std::unique_ptr<Stream> stream_;
+};
@@ -51,6 +51,10 @@ protected:
 
     void changeEvent(QEvent *event) override;
 
+    void showEvent(QShowEvent *event) override;
+
+    void hideEvent(QHideEvent *event) override;
+
 private slots:
     void clearLogs();
 
@@ -68,6 +72,8 @@ private:
 
     void openDashboard();
 
+    void updateGuiDemand();
+
     void refreshPluginsTab();
 
     void setupTray();
@@ -78,18 +84,10 @@ private:
 
     void showRunningNotificationOnce();
 
-    bool writeSecretFile(const QString &s);
-
     void applySecretToWsServer();
 
     void updateSecretUi();
 
-    QString authSecretPath() const;
-
-    QString generate6DigitSecret() const;
-
-    QString loadOrCreateSecret();
-
     QLineEdit *txtAuthKey = nullptr;
     QPushButton *btnCopyAuthKey = nullptr;
     QPushButton *btnRegenAuthKey = nullptr;
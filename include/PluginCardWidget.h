@@ -11,7 +11,7 @@ class QMouseEvent;
 // A compact "card" that visualizes one plugin's runtime status.
 // - fixed size, designed for grid layouts
 // - shows state + short description
-// - shows counters (reads/sent/requests)
+// - shows counters (reads/sent/requests), tick timing and tick CPU share
 // - provides Start/Pause, Restart and (optional) Open UI actions
 class PluginCardWidget final : public QFrame {
     Q_OBJECT
@@ -27,6 +27,9 @@ public:
         bool hasUi
     );
 
+    // First-start phase timings (microseconds), shown in the id label tooltip.
+    void setStartupTiming(uint64_t loadUs, uint64_t resolveUs, uint64_t createUs, uint64_t initUs, uint64_t startUs);
+
     // state: WaPluginState int (WA_STATE_*)
     void updateRuntime(
         int32_t state,
@@ -37,6 +40,51 @@ public:
         qint64 lastRequestMs
     );
 
+    // Tick timing (all durations in microseconds). hasStats=false hides the chip.
+    void updateTiming(
+        bool hasStats,
+        uint64_t ticks,
+        uint64_t overruns,
+        uint64_t skipped,
+        uint64_t lastTickUs,
+        uint64_t p50TickUs,
+        uint64_t p95TickUs,
+        uint64_t maxTickUs,
+        uint64_t p95JitterUs,
+        uint64_t maxJitterUs
+    );
+
+    // readAll() timing (microseconds); late = reads that missed the broadcast deadline.
+    void updateReadTiming(uint64_t lastReadUs, uint64_t maxReadUs, uint64_t late);
+
+    // Host->plugin call latency (microseconds) and watchdog quarantine state.
+    // Call after updateRuntime(): a quarantined plugin overrides the status text.
+    void updateCallTiming(
+        uint64_t calls,
+        uint64_t p50CallUs,
+        uint64_t p95CallUs,
+        uint64_t p99CallUs,
+        uint64_t maxCallUs,
+        bool quarantined,
+        uint32_t quarantines
+    );
+
+    // Cost accounting (durations in microseconds, totals since the handle was created).
+    // The chip shows the tick CPU share of one core since the previous call;
+    // hasCost=false hides it.
+    void updateCost(
+        bool hasCost,
+        uint64_t tickCpuUs,
+        uint64_t tickCpuMaxUs,
+        bool countsAllocs,
+        uint64_t allocs,
+        uint64_t allocBytes,
+        uint64_t readTotalUs,
+        uint64_t requestTotalUs,
+        uint64_t snapshotBytes,
+        uint64_t snapshotBytesTotal
+    );
+
     QString pluginId() const { return pluginId_; }
 
 signals:
@@ -66,6 +114,12 @@ private:
     QLabel* chipReads_ = nullptr;
     QLabel* chipSent_ = nullptr;
     QLabel* chipReq_ = nullptr;
+    QLabel* chipTick_ = nullptr;
+    QLabel* chipCpu_ = nullptr;
+
+    // Previous updateCost() sample for the CPU share
+    uint64_t prevCpuUs_ = 0;
+    qint64 prevCpuAtMs_ = 0;
 
     QLabel* lblLast_ = nullptr;
 
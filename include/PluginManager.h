@@ -2,18 +2,26 @@
 
 #include <cstdint>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
+#include <QSet>
 #include <QString>
 #include <QStringList>
 #include <QLibrary>
 #include <QJsonObject>
+#include <QThread>
+#include <QThreadPool>
 
 #include "BasePlugin.h"
+#include "PluginWorker.h"
+#include "TickScheduler.h"
 
 class QWidget;
 
@@ -32,6 +40,15 @@ public:
         bool hasUi = false;
     };
 
+    // Per-phase wall time of a plugin's first start in loadFromDir() (microseconds)
+    struct StartupTiming {
+        uint64_t loadUs = 0;     // LoadLibrary
+        uint64_t resolveUs = 0;  // export lookup + wa_get_info
+        uint64_t createUs = 0;   // wa_create (plugin constructor)
+        uint64_t initUs = 0;     // wa_init
+        uint64_t startUs = 0;    // wa_set_demand + wa_start
+    };
+
     struct PluginUiSnapshot {
         QString id;
         QString name;
@@ -44,36 +61,185 @@ public:
         uint64_t requests = 0;
         qint64 lastReadMs = 0;
         qint64 lastRequestMs = 0;
+
+        // Tick timing (plugins exporting wa_get_tick_stats); percentiles are
+        // histogram bucket upper bounds.
+        bool hasTickStats = false;
+        uint64_t ticks = 0;
+        uint64_t tickOverruns = 0;
+        uint64_t tickSkipped = 0;
+        uint64_t tickLastUs = 0;
+        uint64_t tickMaxUs = 0;
+        uint64_t tickP50Us = 0;
+        uint64_t tickP95Us = 0;
+        uint64_t jitterP95Us = 0;
+        uint64_t jitterMaxUs = 0;
+
+        // readAll() timing: wa_read + decode, and reads that missed the broadcast deadline
+        uint64_t readLastUs = 0;
+        uint64_t readMaxUs = 0;
+        uint64_t readsLate = 0;
+
+        // Every host -> plugin ABI call (histogram bucket upper bounds, see WaTickStats)
+        uint64_t calls = 0;
+        uint64_t callP50Us = 0;
+        uint64_t callP95Us = 0;
+        uint64_t callP99Us = 0;
+        uint64_t callMaxUs = 0;
+
+        // Watchdog: the current handle was abandoned after a call exceeded the budget
+        bool quarantined = false;
+        uint32_t quarantines = 0;
+
+        // Cost (plugins exporting wa_get_cost_stats): CPU time of the current handle's
+        // ticks; allocations only when the plugin counts them.
+        bool hasCostStats = false;
+        bool countsAllocs = false;
+        uint64_t tickCpuUs = 0;
+        uint64_t tickCpuLastUs = 0;
+        uint64_t tickCpuMaxUs = 0;
+        uint64_t allocs = 0;
+        uint64_t allocBytes = 0;
+        uint64_t allocsLastTick = 0;
+
+        // Host-side cost: wall time inside wa_read* / wa_request* (async: until the
+        // completion) and snapshot bytes read, totals since load
+        uint64_t readTotalUs = 0;
+        uint64_t requestTotalUs = 0;
+        uint64_t snapshotBytes = 0;       // latest snapshot
+        uint64_t snapshotBytesTotal = 0;  // every changed snapshot
+
+        StartupTiming startup;
     };
 
     PluginManager();
+    ~PluginManager();
 
     // hostCtx is passed to wa_create(hostCtx, cfg)
+    // Plugins are loaded, created, initialized and started concurrently; they are
+    // registered in directory order once all of them have finished.
     bool loadFromDir(const QString& dirPath, void* hostCtx);
     void stopAll();
 
-    // Read latest JSON snapshots from all plugins as:
-    QJsonObject readAll();
+    // One module of a readAll (finishReadAll()): the plugin's snapshot as JSON object text, or as the
+    // CBOR map a CBOR plugin wrote (then json is empty). It is validated once per
+    // snapshot and can be spliced verbatim into an outgoing document.
+    struct ModuleJson {
+        QString id;
+        QByteArray json;
+        QByteArray cbor;
+        bool changed = false;  // since finishReadAll() last returned this module
+        bool stale = false;    // read missed the deadline; this is the last good snapshot
+    };
+
+    // Per-plugin cost summary appended to a readAll that asks for it as an extra
+    // module (CPU share, call wall time, snapshot bytes, allocations), rebuilt at
+    // most once a second and only reported changed when its text changed.
+    // The id is reserved: a plugin with this id is not loaded.
+    static constexpr const char* kHostModuleId = "host";
+
+    // Extra top-level member of the kHostModuleId module (e.g. server metrics),
+    // picked up by its next rebuild; an empty section removes it. Thread-safe.
+    void setHostSection(const QString& key, const QJsonObject& section);
+
+    // Read the latest snapshots from all running plugins, in load order, followed
+    // by the kHostModuleId module when asked for. Non-blocking, in two steps:
+    // beginReadAll() starts the reads and calls done (on an arbitrary thread, or
+    // right away when there is nothing to read) once all of them are in;
+    // finishReadAll() takes the snapshots, whether done was called or the caller
+    // gave up waiting after readDeadlineMs(). done is not called after that.
+    // Plugins exporting wa_read_if_changed are only re-validated when their
+    // snapshot generation moved; for the others an unchanged byte sequence
+    // counts as unchanged.
+    // Plugins are read in parallel on a small pool. A plugin whose read has not
+    // finished by finishReadAll() keeps its last good snapshot and is marked
+    // stale; its read completes in the background (on a thread the pool replaces
+    // until then) and is reported as changed by a later readAll.
+    // `only` restricts the read to these ids, "*" standing for every plugin; the
+    // kHostModuleId module is only added when `only` names it. nullptr = every plugin
+    // and the host module. The others keep their changed state for a later call.
+    // `live` (optional) receives the ids of every module that still exists at the
+    // batch's start: running, paused and quarantined plugins and the host module.
+    // Stopped and unloaded ones are missing.
+    // Lock-free (never takes the manager mutex); call finishReadAll() from one thread only.
+    struct ReadBatch;
+    using ReadDone = std::function<void()>;
+    std::shared_ptr<ReadBatch> beginReadAll(const QSet<QString>* only, ReadDone done);
+    std::vector<ModuleJson> finishReadAll(const std::shared_ptr<ReadBatch>& batch, QSet<QString>* live = nullptr);
+
+    // How long a caller of beginReadAll() should wait for done (default 250 ms).
+    void setReadDeadlineMs(uint32_t ms);
+    uint32_t readDeadlineMs() const;
 
     // Route a request to a specific plugin.
     // Returns {} if plugin not found or response invalid.
     QJsonObject request(const QString& id, const QJsonObject& payload);
 
+    // Non-blocking variant: uses wa_request_async when the plugin exports it and
+    // otherwise runs wa_request on a pool thread. done receives the response
+    // ({} if invalid) on an arbitrary thread. Returns false (done is not called)
+    // if the plugin is not found or refused the request.
+    using RequestDone = std::function<void(const QJsonObject&)>;
+    bool requestAsync(const QString& id, const QJsonObject& payload, RequestDone done);
+
+    // Asks a running plugin for one extra tick (wa_tick_now). done runs on an arbitrary
+    // thread once the fresh snapshot is readable (or the plugin stopped). Returns false
+    // (done is not called) if the plugin lacks the export or is not running.
+    using TickDone = std::function<void()>;
+    bool tickNow(const QString& id, TickDone done);
+
     bool has(const QString& id) const;
 
         // ---- UI (optional) ----
     std::vector<PluginDesc> list() const;
-    std::vector<PluginUiSnapshot> snapshotUi() const;
+    std::vector<PluginUiSnapshot> snapshotUi() const;  // lock-free
     QWidget* createWidget(const QString& id, QWidget* parent) const;
 
     // Called by the WS server after broadcasting an update (increments per-plugin sent counters).
     void markSent(const QStringList& pluginIds);
 
+    // ---- Consumer demand (pushed to plugins through wa_set_demand) ----
+    // clients: connected dashboard clients; modules: the ids they receive (nullptr = all).
+    void setClientDemand(int clients, const QSet<QString>* modules = nullptr);
+    void setGuiVisible(bool visible);
+    uint32_t demandFor(const QString& id) const;
+
+    // ---- Call watchdog ----
+    // A read or request running longer than the budget (default 5000 ms, per plugin
+    // "callBudgetMs" in config.json) quarantines the plugin: its handle is abandoned
+    // (never stopped while a call is inside it), reads skip it, and it is recreated
+    // in the background (up to kMaxAutoRestarts times; the count starts over after
+    // ten minutes of running clean). Stop/restart also give up on a hung call after
+    // the budget instead of waiting forever.
+    void setCallBudgetMs(uint32_t ms);
+    static constexpr uint32_t kMaxAutoRestarts = 3;
+
+    // ---- Worker processes ----
+    // Plugins with "workerProcess": true in config.json run in their own
+    // WinAgentPluginHost process (see PluginWorker); a worker that dies is
+    // quarantined and restarted like a hung handle. Set before loadFromDir().
+    void setWorkerExecutable(const QString& path);  // default: <app dir>/WinAgentPluginHost
+
     // ---- Lifecycle controls ----
+    // These block until the plugin is stopped or its new handle has published a
+    // first snapshot (up to the call budget each step).
     int32_t startPlugin(const QString& id);
     int32_t stopPlugin(const QString& id);
     int32_t restartPlugin(const QString& id);
 
+    // Non-blocking variants for the GUI thread: the control runs on the background
+    // control thread and done receives its result code there.
+    using ControlDone = std::function<void(int32_t rc)>;
+    void startPluginAsync(const QString& id, ControlDone done);
+    void stopPluginAsync(const QString& id, ControlDone done);
+    void restartPluginAsync(const QString& id, ControlDone done);
+    // Re-reads config.json and applies it to the running handle (wa_configure);
+    // restarts the plugin when it has no wa_configure or cannot apply the change live.
+    // wa_configure waits for the plugin's next tick boundary: use the async variant
+    // from the GUI thread.
+    int32_t reconfigurePlugin(const QString& id);
+    void reconfigurePluginAsync(const QString& id, ControlDone done);
+
     int32_t pluginState(const QString& id) const;
 
     // Convenience for plugins to use (points back to this manager)
@@ -90,6 +256,14 @@ private:
     using FnDestroy = void (WA_CALL*)(void*);
     using FnRead    = WaView (WA_CALL*)(void*);
     using FnReq     = WaView (WA_CALL*)(void*, const char*);
+    using FnReqAsync = int32_t (WA_CALL*)(void*, const char*, uint64_t, WaRequestDoneFn, void*);
+    using FnReadIfChanged = WaView (WA_CALL*)(void*, uint64_t, uint64_t*);
+    using FnGetTickStats = int32_t (WA_CALL*)(void*, WaTickStats*);
+    using FnGetCostStats = int32_t (WA_CALL*)(void*, WaCostStats*);
+    using FnSetDemand = void (WA_CALL*)(void*, uint32_t);
+    using FnTickNow = int32_t (WA_CALL*)(void*, WaTickDoneFn, void*);
+    using FnConfigure = int32_t (WA_CALL*)(void*, const char*);
+    using FnViewFormat = uint32_t (WA_CALL*)(void*);
     using FnCreateWidget = QWidget* (WA_CALL*)(void* pluginHandle, QWidget* parent);
 
     enum class State : int32_t {
@@ -100,8 +274,38 @@ private:
         Error   = WA_STATE_ERROR,
     };
 
+    // One created plugin handle. Calls count themselves on the instance they use, so
+    // an abandoned (hung) handle keeps its own counters and never blocks its successor.
+    struct Instance {
+        void* handle = nullptr;
+        uint32_t format = WA_FMT_JSON;  // wa_get_view_format, fixed for the handle
+        std::atomic<bool> detached{false};  // readers back off; set before stop/abandon
+
+        // Calls made under mu_ (requests, widgets, demand) that stop/restart wait for
+        std::atomic<int> inFlight{0};
+
+        // Lock-free read pins (readAll/snapshotUi): readers bump `readers`, then use
+        // the handle unless `detached` is set. Writers set it before stopping the
+        // handle and wait for `readers` to drain (see pinHandle/waitNoReaders).
+        std::atomic<int> readers{0};
+
+        // readAll() job for this handle; lastGeneration/lastRaw belong to the running job
+        std::atomic<bool> reading{false};
+        uint64_t lastGeneration = 0;
+        QByteArray lastRaw;  // plain wa_read: previous view bytes, for change detection
+
+        // Serializes wa_request calls (each reply view lives until the next call)
+        std::mutex reqMu;
+
+        // Watchdog: steady-clock start (us, 0 = idle) of the running read / wa_request
+        std::atomic<int64_t> readSinceUs{0};
+        std::atomic<int64_t> requestSinceUs{0};
+        std::unordered_map<uint64_t, int64_t> asyncSinceUs;  // pending wa_request_async (mu_)
+    };
+
     struct Loaded {
-        QLibrary lib;
+        QLibrary lib;  // not loaded for worker plugins
+        std::unique_ptr<PluginWorker> worker;  // worker plugins: the ABI functions below are its shims
 
         FnGetInfo get_info = nullptr;
         FnCreate  create = nullptr;
@@ -114,32 +318,132 @@ private:
 
         FnRead    read = nullptr;
         FnReq     req = nullptr;
+        FnReqAsync req_async = nullptr;
+        FnReadIfChanged read_if_changed = nullptr;
+        FnGetTickStats get_tick_stats = nullptr;
+        FnGetCostStats get_cost_stats = nullptr;
+        FnSetDemand set_demand = nullptr;
+        FnTickNow tick_now = nullptr;
+        FnConfigure configure = nullptr;
+        FnViewFormat view_format = nullptr;
 
         // Optional: create a Qt widget for plugin UI
         FnCreateWidget create_widget = nullptr;
 
         const WaPluginInfo* info = nullptr;
-        void* handle = nullptr;
+        std::shared_ptr<Instance> inst;  // current handle (null when none)
         QString configPath;
         State state = State::Stopped;
 
-        // UI metadata
+        // Watchdog (guarded by mu_)
+        uint32_t callBudgetMs = 0;  // 0 = manager default
+        bool quarantined = false;
+        uint32_t quarantines = 0;  // by the watchdog, since the plugin last ran clean
+        int64_t liveSinceUs = 0;   // steady clock (us) when the current handle was swapped in
+        std::vector<std::shared_ptr<Instance>> abandoned;  // hung handles, reaped once idle
+        std::atomic<int> reaping{0};  // old/abandoned handles being stopped (keeps the library loaded)
+        bool recreating = false;      // a new handle is starting next to the current one
+
+        // UI metadata (copied from info at load, immutable afterwards; stays
+        // readable after the library is unloaded)
+        QString id;
+        QString name;
         QString description;
+        uint32_t defaultIntervalMs = 0;
+        StartupTiming startup;
+
+        // Last WaDemand bits pushed to the current handle
+        uint32_t demand = 0;
+
+        // Last validated snapshot (reused while the generation does not move), written
+        // by read jobs and taken by readAll(), also when the job is late.
+        std::mutex snapMu;
+        QByteArray lastJson;
+        QByteArray lastCbor;  // instead of lastJson for CBOR handles
+        bool snapshotDirty = false;  // changed since readAll() last collected it
 
         // Runtime stats (for the Dashboard overview)
-        std::atomic<int> inFlight{0};
-        uint64_t reads = 0;
-        uint64_t sent = 0;
-        uint64_t requests = 0;
-        qint64 lastReadMs = 0;
-        qint64 lastRequestMs = 0;
+        std::atomic<uint64_t> reads{0};
+        std::atomic<uint64_t> sent{0};
+        std::atomic<uint64_t> requests{0};
+        std::atomic<qint64> lastReadMs{0};
+        std::atomic<qint64> lastRequestMs{0};
+        std::atomic<uint64_t> readLastUs{0};
+        std::atomic<uint64_t> readMaxUs{0};
+        std::atomic<uint64_t> readsLate{0};
+        std::atomic<uint64_t> callUsHist[WA_TICK_HIST_BUCKETS]{};
+        std::atomic<uint64_t> callMaxUs{0};
+        std::atomic<uint64_t> readTotalUs{0};
+        std::atomic<uint64_t> requestTotalUs{0};
+        std::atomic<uint64_t> snapshotBytes{0};
+        std::atomic<uint64_t> snapshotBytesTotal{0};
     };
 
     mutable std::mutex mu_;
     mutable std::condition_variable cv_;
-    std::vector<std::unique_ptr<Loaded>> plugins_;
+    std::vector<std::shared_ptr<Loaded>> plugins_;
     std::unordered_map<std::string, size_t> byId_;
 
+    // Immutable copy of the plugin list for the lock-free paths (readAll, snapshotUi,
+    // markSent), republished under mu_ whenever a plugin's state or handle changes.
+    // Readers pin it like BasePlugin snapshots; entries keep their Loaded alive.
+    struct TableEntry {
+        std::shared_ptr<Loaded> p;
+        std::shared_ptr<Instance> inst;
+        State state = State::Stopped;
+        bool quarantined = false;
+        uint32_t quarantines = 0;
+    };
+    struct Table {
+        std::vector<TableEntry> entries;
+    };
+    std::atomic<std::shared_ptr<const Table>> table_;
+    void publishTableNoLock();
+
+    // readAll fan-out
+    static void readPlugin(Loaded* p, Instance* inst, qint64 nowMs);
+    void readJobDone(const std::shared_ptr<ReadBatch>& batch, size_t i);
+
+    // Host module (finishReadAll() thread only): previous CPU totals for the shares
+    struct CostSample {
+        uint64_t tickCpuUs = 0;
+        uint64_t readTotalUs = 0;
+        uint64_t requestTotalUs = 0;
+    };
+    ModuleJson hostModule();
+    QByteArray hostModuleJson_;
+    int64_t hostModuleAtUs_ = 0;
+    uint64_t hostProcessCpuUs_ = 0;
+    std::unordered_map<std::string, CostSample> hostPrev_;
+    std::mutex hostSectionsMu_;
+    QJsonObject hostSections_;
+    std::atomic<uint32_t> readDeadlineMs_{250};
+    // Base size plus one thread per read that missed its deadline and is still running
+    std::mutex readPoolMu_;
+    int readPoolBase_ = 2;
+    int readPoolLate_ = 0;
+    void resizeReadPool(int lateDelta);
+    QThreadPool readPool_;
+
+    static bool pinHandle(Instance* inst);
+    static void unpinHandle(Instance* inst);
+    // false when readers are still inside after timeout (the handle must be abandoned)
+    static bool waitNoReaders(Instance* inst, std::chrono::milliseconds timeout);
+
+    // Watchdog
+    std::atomic<uint32_t> callBudgetMs_{5000};
+    std::thread watchdog_;
+    std::condition_variable watchdogCv_;
+    bool watchdogStop_ = false;  // guarded by mu_
+    QThreadPool controlPool_;    // background restarts, async controls, old handle retirement
+    void startWatchdog();
+    void stopWatchdog();
+    void watchdogMain();
+    std::chrono::milliseconds budgetNoLock(const Loaded* p) const;
+    void quarantineNoLock(Loaded* p, const QString& why);
+    // Returns the call's wall time (us)
+    static uint64_t recordCall(Loaded* p, std::chrono::steady_clock::time_point t0);
+
     // Remember for restart
     QString pluginsDir_;
     void* hostCtx_ = nullptr;
@@ -147,14 +451,77 @@ private:
     // Host API instance passed to plugins (stable for app lifetime)
     WaHostApi hostApi_{};
 
+    // Consumer demand (guarded by mu_); demandPushMu_ keeps pushes in order
+    int demandClients_ = 0;
+    bool demandAllModules_ = true;
+    QSet<QString> demandModules_;
+    bool guiVisible_ = true;
+    std::mutex demandPushMu_;
+    uint32_t demandForNoLock(const QString& id) const;
+    void publishDemand();
+
+    // Worker pool for plugins running with "sharedScheduler" (threads start on first use)
+    TickScheduler scheduler_;
+
     static QJsonObject parseJsonObjectUtf8(const char* ptr, uint32_t len);
+    // Decodes a plugin view in its handle's WaFormat.
+    static QJsonObject parseViewObject(const WaView& v, uint32_t format);
 
-    void waitNoInflight(std::unique_lock<std::mutex>& lk, PluginManager::Loaded* p, std::condition_variable& cv);
+    // In-flight request bookkeeping shared by request() and requestAsync()
+    struct PendingRequest {
+        PluginManager* self = nullptr;
+        std::shared_ptr<Loaded> plugin;
+        std::shared_ptr<Instance> inst;
+        uint32_t format = WA_FMT_JSON;
+        std::chrono::steady_clock::time_point t0;
+        RequestDone done;
+    };
+    void releaseCall(Instance* inst, uint64_t asyncRequestId = 0);
+    static void WA_CALL host_request_done(void* user, uint64_t requestId, WaView response);
+    static void WA_CALL host_tick_done(void* user, uint64_t generation);
+    uint64_t nextRequestId_ = 1;
+
+    // Waits until the current instance has no calls in flight. A call still running
+    // after the budget is treated as hung: the plugin is quarantined and false returned.
+    bool waitNoInflight(std::unique_lock<std::mutex>& lk, PluginManager::Loaded* p, std::condition_variable& cv);
+
+    // Stops and destroys a detached instance once no reader is inside, or abandons it.
+    void retireInstance(Loaded* p, std::shared_ptr<Instance> inst, std::chrono::milliseconds budget);
+    // Blue/green replacement (start, restart): the new instance is created, inited and
+    // started next to the current one and swapped in after its first snapshot; the
+    // old one is retired on controlPool_. WA_ERR_BAD_STATE while one is already starting.
+    int32_t recreate(std::unique_lock<std::mutex>& lk, const std::shared_ptr<Loaded>& p);
 
     // Internal helpers (mu_ must be held)
     Loaded* findLoadedNoLock(const QString& id) const;
+    std::shared_ptr<Loaded> findSharedNoLock(const QString& id) const;
+
+    // Loads one plugin up to Running (nullptr on failure); safe to run concurrently.
+    std::shared_ptr<Loaded> loadOne(const QString& dllPath, const QString& configPath, void* hostCtx);
+    // wa_create, in process or in a fresh worker process
+    void* createHandle(Loaded* p, void* hostCtx, const QByteArray& cfgJson, std::chrono::milliseconds budget);
+
+    // Worker processes: socket I/O of all workers runs on workerIo_ (started on first use)
+    void bindWorker(Loaded* p);
+    QThread* workerIo();
+    QThread workerIo_;
+    std::once_flag workerIoOnce_;
+    QString workerExe_;
+    std::mutex loaderMu_;  // SetDllDirectoryW (Windows) is process-wide: one library load at a time
+
     static int32_t WA_CALL host_get_state(void* user, const char* pluginIdUtf8);
     static int32_t WA_CALL host_start(void* user, const char* pluginIdUtf8);
     static int32_t WA_CALL host_stop(void* user, const char* pluginIdUtf8);
     static int32_t WA_CALL host_restart(void* user, const char* pluginIdUtf8);
+    static int32_t WA_CALL host_reconfigure(void* user, const char* pluginIdUtf8);
+
+    // Shared tick scheduler (WaHostApi v2)
+    static uint64_t WA_CALL host_sched_register(void* user, WaTaskFn fn, void* taskUser, uint32_t intervalMs);
+    static void WA_CALL host_sched_unregister(void* user, uint64_t taskId);
+    static void WA_CALL host_sched_set_interval(void* user, uint64_t taskId, uint32_t intervalMs);
+    static void WA_CALL host_sched_set_active(void* user, uint64_t taskId, int32_t active);
+    static void WA_CALL host_sched_wake(void* user, uint64_t taskId);
+
+    // Consumer demand (WaHostApi v3)
+    static uint32_t WA_CALL host_demand_get(void* user, const char* pluginIdUtf8);
 };
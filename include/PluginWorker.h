@@ -0,0 +1,194 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QIODevice>
+#include <QString>
+
+#include "BasePlugin.h"
+
+class QThread;
+class WorkerProcess;
+
+// Wire protocol between the host and a plugin worker process (local socket).
+// Frame: quint32 body size (little endian), then the body: quint8 op, quint64 id
+// and the op's fields written with QDataStream. Every host -> worker op gets
+// exactly one Reply with the same id. A body above maxBody() is a protocol error
+// and ends the connection (the host then kills and respawns the worker).
+namespace WorkerIpc {
+    enum Op : quint8 {
+        // host -> worker
+        Create = 1,       // QByteArray cfg (null = no config)        -> qint32 rc, quint32 WaFormat of the views
+        Init,             //                                          -> qint32 rc
+        Start,
+        Pause,
+        Resume,
+        Stop,
+        Destroy,          // the worker exits after replying
+        Request,          // QByteArray json                          -> QByteArray view
+        RequestAsync,     // QByteArray json, quint64 requestId       -> qint32 rc (+ AsyncDone later)
+        SetDemand,        // quint32 flags                            -> qint32 rc
+        TickNow,          // quint64 tickId                           -> qint32 rc (+ TickDone later)
+        Configure,        // QByteArray cfg                           -> qint32 rc
+        Read,             // (oversize snapshots)                     -> quint64 gen, QByteArray view
+        HostReply,        // qint32 rc (answer to a HostCall)
+
+        // worker -> host
+        Hello = 64,       // bool ok, QString error, quint32 apiVersion, QByteArray id, name, desc,
+                          // quint32 defaultIntervalMs, quint32 exports (ExportBits)
+        Reply,            // fields depend on the request op
+        AsyncDone,        // quint64 requestId, QByteArray view
+        TickDone,         // quint64 tickId, quint64 generation (already in the ring)
+        HostCall,         // quint8 HostFn, QByteArray pluginId      -> HostReply
+    };
+
+    enum HostFn : quint8 {
+        GetState = 1,
+        StartPlugin,
+        StopPlugin,
+        RestartPlugin,
+        ReconfigurePlugin,
+        GetDemand,        // rc = the plugin's WaDemand bits
+    };
+
+    // Optional exports present in the worker's library
+    enum ExportBits : quint32 {
+        HasPause         = 1u << 0,
+        HasResume        = 1u << 1,
+        HasReadIfChanged = 1u << 2,
+        HasTickStats     = 1u << 3,
+        HasRequestAsync  = 1u << 4,
+        HasSetDemand     = 1u << 5,
+        HasTickNow       = 1u << 6,
+        HasConfigure     = 1u << 7,
+        HasCostStats     = 1u << 8,
+    };
+
+    // Stats the worker keeps in its ring (SnapshotRing::publishStats); rc as the
+    // plugin's wa_get_tick_stats / wa_get_cost_stats returned it.
+    struct Stats {
+        int32_t tickRc;
+        int32_t costRc;
+        WaTickStats tick;
+        WaCostStats cost;
+    };
+
+    // Views (snapshots, responses) crossing the socket are capped at a few ring
+    // slots; the slack covers the op and the rest of its fields.
+    constexpr quint32 kMaxViewSlots = 4;
+    constexpr quint32 kFrameSlack = 64 * 1024;
+    constexpr quint32 maxView(quint32 slotBytes) { return slotBytes * kMaxViewSlots; }
+    constexpr quint32 maxBody(quint32 slotBytes) { return maxView(slotBytes) + kFrameSlack; }
+
+    enum class Take {
+        Incomplete,  // buf does not hold a whole frame yet
+        Frame,       // op/id/fields filled, frame removed from buf
+        Invalid,     // body size below the minimum or above maxBody: drop the peer
+    };
+
+    QByteArray frame(Op op, quint64 id, const QByteArray& fields = {});
+    // Pops one complete frame from buf.
+    Take takeFrame(QByteArray& buf, quint32 maxBody, Op& op, quint64& id, QByteArray& fields);
+
+    template <typename... Args>
+    QByteArray pack(const Args&... args) {
+        QByteArray out;
+        QDataStream ds(&out, QIODevice::WriteOnly);
+        ds.setVersion(QDataStream::Qt_6_0);
+        (ds << ... << args);
+        return out;
+    }
+
+    template <typename... Args>
+    bool unpack(const QByteArray& fields, Args&... args) {
+        QDataStream ds(fields);
+        ds.setVersion(QDataStream::Qt_6_0);
+        (ds >> ... >> args);
+        return ds.status() == QDataStream::Ok;
+    }
+}
+
+// PluginWorker
+// ------------
+// Out-of-process hosting for one plugin ("workerProcess": true in its config.json).
+// Every plugin handle is a WinAgentPluginHost process that loads the DLL, so a
+// crash or leak in COM/WinRT/driver code only takes that process down.
+//
+// The static shims below have the same signatures as the plugin exports and take
+// the worker process as the handle, so PluginManager drives a worker exactly like
+// an in-process handle (watchdog, blue/green restart, demand, async requests):
+// - snapshots: the worker copies every new generation into a SnapshotRing; reads
+//   are a shared-memory copy and never wait on the worker
+// - stats: the worker refreshes them in the ring header a few times a second
+// - everything else: one round-trip over a local socket per call
+//
+// A worker that exits is reported by exited(); PluginManager quarantines it and
+// starts a fresh process. Socket I/O runs on `io` (an event loop owned by the host).
+class PluginWorker {
+public:
+    PluginWorker(QThread* io, QString workerExe, QString libraryPath, uint32_t ringKiB);
+    ~PluginWorker();
+
+    PluginWorker(const PluginWorker&) = delete;
+    PluginWorker& operator=(const PluginWorker&) = delete;
+
+    // Spawns the first worker and reads the plugin's info and exports. The process
+    // is kept for the first create().
+    bool probe(std::chrono::milliseconds timeout, QString* error);
+
+    const WaPluginInfo* info() const { return &info_; }
+    bool has(WorkerIpc::ExportBits e) const { return (exports_ & e) != 0; }
+
+    // wa_create in a worker process (a fresh one unless the probe's is still unused),
+    // spawn and create within `timeout`. Returns the handle for the shims below,
+    // nullptr on failure.
+    void* create(void* hostCtx, const char* configJsonUtf8, std::chrono::milliseconds timeout);
+
+    // Handle helpers (thread-safe)
+    static bool exited(void* handle);
+    static QString exitReason(void* handle);
+    static void kill(void* handle);
+    // Calls on the handle that are still waiting at `deadline` kill the worker and
+    // fail (startup: create/init/start within one budget). max() = no deadline.
+    static void setDeadline(void* handle, std::chrono::steady_clock::time_point deadline);
+
+    // ABI shims
+    static int32_t WA_CALL init(void* handle);
+    static int32_t WA_CALL start(void* handle);
+    static int32_t WA_CALL pause(void* handle);
+    static int32_t WA_CALL resume(void* handle);
+    static int32_t WA_CALL stop(void* handle);
+    static void    WA_CALL destroy(void* handle);
+    static WaView  WA_CALL request(void* handle, const char* requestJsonUtf8);
+    static WaView  WA_CALL read(void* handle);
+    static WaView  WA_CALL readIfChanged(void* handle, uint64_t lastSeenGeneration, uint64_t* generationOut);
+    static int32_t WA_CALL getTickStats(void* handle, WaTickStats* out);
+    static int32_t WA_CALL getCostStats(void* handle, WaCostStats* out);
+    static void    WA_CALL setDemand(void* handle, uint32_t demandFlags);
+    static int32_t WA_CALL requestAsync(void* handle, const char* requestJsonUtf8,
+                                        uint64_t requestId, WaRequestDoneFn done, void* doneUser);
+    static int32_t WA_CALL tickNow(void* handle, WaTickDoneFn done, void* doneUser);
+    static int32_t WA_CALL configure(void* handle, const char* configJsonUtf8);
+    static uint32_t WA_CALL viewFormat(void* handle);  // as reported on create
+
+    // Entry point of the worker executable (see pluginhost.cpp).
+    static int workerMain(const QString& libraryPath, const QString& serverName, const QString& ringKey);
+
+private:
+    WorkerProcess* launch(std::chrono::milliseconds timeout, QString* error);
+
+    QThread* io_;
+    QString exe_;
+    QString library_;
+    uint32_t ringBytes_;
+
+    // Plugin info as reported by the probe (info_ points into these)
+    QByteArray id_, name_, desc_;
+    WaPluginInfo info_{};
+    quint32 exports_ = 0;
+
+    WorkerProcess* spare_ = nullptr;  // probed process, not created yet
+};
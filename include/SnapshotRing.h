@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include <QByteArray>
+#include <QSharedMemory>
+#include <QString>
+
+// SnapshotRing
+// ------------
+// Shared-memory ring of plugin snapshots between a plugin worker process (the
+// only writer) and the host (readers). Each slot is a seqlock: the writer makes
+// the slot's sequence odd, copies the snapshot in and makes it even again, and
+// readers retry when the sequence moved under them. Generation g lives in slot
+// g % slotCount, so a reader only races the writer after `slotCount` newer snapshots.
+//
+// A snapshot larger than a slot is not copied; its slot is marked oversize and
+// the reader fetches it over the worker's IPC channel instead.
+//
+// The header also carries a small stats record (seqlock as well) that the worker
+// refreshes on its own, so the host reads plugin stats without a round-trip.
+class SnapshotRing {
+public:
+    enum class ReadResult {
+        Empty,      // nothing published yet
+        Unchanged,  // latest generation equals lastSeenGeneration
+        Ok,         // out/generation filled
+        Oversize,   // generation filled; the bytes did not fit into a slot
+    };
+
+    static constexpr uint32_t kDefaultSlots = 4;
+    static constexpr uint32_t kStatsBytes = 1024;
+
+    SnapshotRing() = default;
+    ~SnapshotRing();
+
+    SnapshotRing(const SnapshotRing&) = delete;
+    SnapshotRing& operator=(const SnapshotRing&) = delete;
+
+    // Host: creates the segment (slotBytes of payload per slot).
+    bool create(const QString& key, uint32_t slotBytes, uint32_t slotCount = kDefaultSlots);
+    // Worker: attaches to a segment created by the host.
+    bool attach(const QString& key);
+    void detach();
+
+    bool isValid() const { return header_ != nullptr; }
+    uint32_t slotBytes() const { return slotBytes_; }
+    QString errorString() const { return shm_.errorString(); }
+
+    // Single writer. Generations must grow.
+    void publish(uint64_t generation, const char* data, uint32_t len);
+
+    // Any number of readers. out keeps its capacity between calls.
+    ReadResult readLatest(uint64_t lastSeenGeneration, QByteArray& out, uint64_t& generation) const;
+
+    // Stats record (at most kStatsBytes). Single writer; false until the first
+    // publish or when a reader keeps racing the writer.
+    void publishStats(const void* data, uint32_t len);
+    bool readStats(void* out, uint32_t len) const;
+
+private:
+    struct Header;
+    struct Slot;
+
+    static constexpr uint32_t kMagic = 0x57415352;  // "WASR"
+    static constexpr uint32_t kVersion = 2;
+    static constexpr uint32_t kOversize = UINT32_MAX;
+
+    void setKey(const QString& key);
+    bool mapHeader();
+    Slot* slot(uint64_t generation) const;
+
+    QSharedMemory shm_;
+    Header* header_ = nullptr;
+    uint32_t slotCount_ = 0;
+    uint32_t slotBytes_ = 0;
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "BasePlugin.h"
+
+// TickScheduler
+// -------------
+// Shared periodic task runner handed to plugins through WaHostApi (sched_*).
+// One timer thread keeps a deadline heap and a small worker pool runs the due
+// tasks, so N plugins tick on a handful of threads instead of one each.
+//
+// Guarantees per task:
+// - fixed-rate: runs are due at start + k * interval; slots missed by a slow
+//   run are skipped (plugins request catch-up runs with wake())
+// - a task never runs concurrently with itself
+// - remove() returns only after a running invocation has finished
+//   (do not call remove() from inside the task itself)
+class TickScheduler {
+public:
+    using TaskFn = WaTaskFn;
+
+    // workers == 0 -> one per core (clamped to a small pool)
+    explicit TickScheduler(unsigned workers = 0);
+    ~TickScheduler();
+
+    TickScheduler(const TickScheduler&) = delete;
+    TickScheduler& operator=(const TickScheduler&) = delete;
+
+    // Returns a non-zero task id. The task is active and due immediately.
+    uint64_t add(TaskFn fn, void* user, uint32_t intervalMs);
+    void remove(uint64_t id);
+
+    void setInterval(uint64_t id, uint32_t intervalMs);
+    void setActive(uint64_t id, bool active);
+
+    // Run the task as soon as a worker is free (coalesced if already pending).
+    // Also works for inactive tasks (one extra run, no re-arm). A wake ahead of
+    // the next timer does not move the timer.
+    void wake(uint64_t id);
+
+    // Stops all threads; pending tasks are dropped.
+    void shutdown();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Task {
+        TaskFn   fn = nullptr;
+        void*    user = nullptr;
+        uint32_t intervalMs = 1000;
+        bool     active = true;
+        bool     queued = false;   // sitting in ready_
+        bool     running = false;  // a worker is inside fn
+        bool     rerun = false;    // wake() arrived while running
+        bool     woken = false;    // queued by wake(): runs even when inactive
+        uint64_t seq = 0;          // invalidates stale heap entries
+        Clock::time_point due{};
+    };
+
+    struct Timer {
+        Clock::time_point due;
+        uint64_t id;
+        uint64_t seq;
+        bool operator>(const Timer& o) const { return due > o.due; }
+    };
+
+    void ensureThreadsNoLock();
+    void armNoLock(uint64_t id, Task& t, Clock::time_point due);
+    void enqueueNoLock(uint64_t id, Task& t);
+    void timerMain();
+    void workerMain();
+
+    std::mutex mu_;
+    std::condition_variable timerCv_;
+    std::condition_variable workCv_;
+    std::condition_variable doneCv_;
+
+    std::unordered_map<uint64_t, Task> tasks_;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<>> timers_;
+    std::deque<uint64_t> ready_;
+
+    std::thread timerThread_;
+    std::vector<std::thread> workers_;
+    unsigned workerCount_ = 1;
+    bool started_ = false;
+    bool stopping_ = false;
+    uint64_t nextId_ = 1;
+};
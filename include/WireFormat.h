@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QString>
+
+// Snapshot and update encoding helpers shared by the plugin manager and the
+// dashboard server. No state; safe from any thread.
+namespace WireFormat {
+    // Snapshot view -> bytes kept for broadcasts (JSON object text, or the CBOR map
+    // as written); empty if invalid, {} or not in `format` (WaFormat). JSON is only
+    // syntax-checked, not parsed, so it can be spliced into updates verbatim.
+    QByteArray validView(const QByteArray &raw, uint32_t format);
+
+    // RFC 7386 merge patch turning `from` into `to`; false if it cannot express the
+    // change (a null value inside `to`, since null removes the member).
+    bool mergePatch(const QJsonObject &from, const QJsonObject &to, QJsonObject &patch);
+
+    // CBOR item head (RFC 8949 3.1): major type and argument, shortest form.
+    void cborHead(QByteArray &out, quint8 major, quint64 value);
+    void cborText(QByteArray &out, const QString &s);
+}
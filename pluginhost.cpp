@@ -0,0 +1,34 @@
+#include <cstdio>
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+
+#include "PluginWorker.h"
+
+// Plugin worker process: hosts one plugin DLL for a WinAgent host that started
+// it (plugins with "workerProcess": true). Not meant to be run by hand.
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    app.setApplicationName("WinAgent Plugin Host");
+    app.setApplicationVersion("0.2.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Runs one WinAgent plugin out of process (started by the host).");
+    parser.addHelpOption();
+    const QCommandLineOption libraryOpt("library", "Plugin library to load.", "path");
+    const QCommandLineOption serverOpt("server", "Host's local socket name.", "name");
+    const QCommandLineOption ringOpt("ring", "Shared-memory snapshot ring key.", "key");
+    parser.addOption(libraryOpt);
+    parser.addOption(serverOpt);
+    parser.addOption(ringOpt);
+    parser.process(app);
+
+    if (!parser.isSet(libraryOpt) || !parser.isSet(serverOpt) || !parser.isSet(ringOpt)) {
+        std::fprintf(stderr, "%s\n", qUtf8Printable(parser.helpText()));
+        return 2;
+    }
+
+    return PluginWorker::workerMain(parser.value(libraryOpt), parser.value(serverOpt), parser.value(ringOpt));
+}
@@ -23,7 +23,7 @@ static WaPluginInfo INFO{
 class AudioDevicesPlugin final : public BasePlugin {
 public:
     explicit AudioDevicesPlugin(void* hostCtx, const char *configJsonUtf8)
-        : BasePlugin(INFO.defaultIntervalMs, configJsonUtf8),
+        : BasePlugin(INFO.defaultIntervalMs, configJsonUtf8, static_cast<WaHostApi*>(hostCtx)),
           hostApi_(static_cast<WaHostApi*>(hostCtx)) {
     }
 
@@ -128,6 +128,22 @@ WA_EXPORT WaView WA_CALL    wa_read(void *h) {
         ? ((AudioDevicesPlugin *) h)->readView()
         : WaView{nullptr, 0};
 }
+WA_EXPORT WaView WA_CALL    wa_read_if_changed(void *h, uint64_t lastSeen, uint64_t *genOut) {
+    return h
+        ? ((AudioDevicesPlugin *) h)->readViewIfChanged(lastSeen, genOut)
+        : WaView{nullptr, 0};
+}
+WA_EXPORT int32_t WA_CALL   wa_get_tick_stats(void *h, WaTickStats *out) { return h ? ((AudioDevicesPlugin *) h)->tickStats(out) : WA_ERR_BAD_ARG; }
+WA_EXPORT int32_t WA_CALL   wa_get_cost_stats(void *h, WaCostStats *out) { return h ? ((AudioDevicesPlugin *) h)->costStats(out) : WA_ERR_BAD_ARG; }
+WA_EXPORT uint32_t WA_CALL  wa_get_view_format(void *h)           { return h ? ((AudioDevicesPlugin *) h)->viewFormat() : WA_FMT_JSON; }
+WA_EXPORT void WA_CALL      wa_set_demand(void *h, uint32_t demand)    { if (h) ((AudioDevicesPlugin *) h)->setDemand(demand); }
+WA_EXPORT int32_t WA_CALL   wa_tick_now(void *h, WaTickDoneFn done, void *user) { return h ? ((AudioDevicesPlugin *) h)->requestImmediateTick(done, user) : WA_ERR_BAD_ARG; }
+WA_EXPORT int32_t WA_CALL   wa_configure(void *h, const char *cfg) { return h ? ((AudioDevicesPlugin *) h)->configure(cfg) : WA_ERR_BAD_ARG; }
+WA_EXPORT int32_t WA_CALL   wa_request_async(void *h, const char *reqJsonUtf8, uint64_t reqId, WaRequestDoneFn done, void *user) {
+    return h
+        ? ((AudioDevicesPlugin *) h)->requestAsync(reqJsonUtf8, reqId, done, user)
+        : WA_ERR_BAD_ARG;
+}
 
 // Optional UI export
 WA_EXPORT QWidget* WA_CALL wa_create_widget(void* pluginHandle, QWidget* parent) {
@@ -93,7 +93,9 @@ BasicMemoryUi::BasicMemoryUi(WaHostApi* api, QWidget* parent)
     connect(btnSave_, &QPushButton::clicked, this, [this]() {
         if (!saveToDisk()) return;
 
-        if (api_ && api_->plugin_restart) {
+        if (api_ && api_->apiVersion >= 4 && api_->plugin_reconfigure) {
+            api_->plugin_reconfigure(api_->user, kPluginId);
+        } else if (api_ && api_->plugin_restart) {
             api_->plugin_restart(api_->user, kPluginId);
         }
 
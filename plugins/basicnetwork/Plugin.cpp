@@ -1,6 +1,5 @@
 #include "BasePlugin.h"
 
-#include <QJsonArray>
 #include <QJsonObject>
 #include <QString>
 
@@ -20,10 +19,10 @@ static WaPluginInfo INFO{
     1000
 };
 
-class BasicNetworkPlugin final : public BasePlugin {
+class BasicNetworkPlugin final : public StreamingPlugin {
 public:
     explicit BasicNetworkPlugin(void* hostCtx, const char *configJsonUtf8)
-        : BasePlugin(INFO.defaultIntervalMs, configJsonUtf8),
+        : StreamingPlugin(INFO.defaultIntervalMs, configJsonUtf8, static_cast<WaHostApi*>(hostCtx)),
           hostApi_(static_cast<WaHostApi*>(hostCtx)) {
     }
 
@@ -36,28 +35,34 @@ protected:
         return true;
     }
 
+    // The filter is only read by ticks, so a new one can be swapped in between them.
+    bool onReconfigure(const QJsonObject &cfg) override {
+        sampler_.init(cfg);
+        return true;
+    }
+
     void onStop() override {
     }
 
-    QJsonObject onTick() override {
+    bool onTickWrite(SnapshotWriter &w) override {
         std::map<std::wstring, InterfaceData> data = sampler_.update();
 
-        QJsonArray interfaces = {};
+        w.beginObject();
+        w.field("ok", true);
+        w.key("interfaces").beginArray();
         for (auto &[name, iface]: data) {
-            interfaces.append(QJsonObject{
-                {"name", QString::fromStdWString(iface.name)},
-                {"description", QString::fromStdWString(iface.description)},
-                {"guid", QString::fromStdWString(iface.guid)},
-                {"rxSpeed", iface.speedInKB},
-                {"txSpeed", iface.speedOutKB}
-            });
+            w.beginObject()
+                .field("name", std::wstring_view(iface.name))
+                .field("description", std::wstring_view(iface.description))
+                .field("guid", std::wstring_view(iface.guid))
+                .field("rxSpeed", iface.speedInKB)
+                .field("txSpeed", iface.speedOutKB)
+                .endObject();
         }
+        w.endArray();
+        w.endObject();
 
-        QJsonObject snap;
-        snap.insert("ok", true);
-        snap.insert("interfaces", interfaces);
-
-        return snap;
+        return true;
     }
 
 private:
@@ -90,6 +95,22 @@ WA_EXPORT WaView WA_CALL    wa_read(void *h) {
         ? ((BasicNetworkPlugin *) h)->readView()
         : WaView{nullptr, 0};
 }
+WA_EXPORT WaView WA_CALL    wa_read_if_changed(void *h, uint64_t lastSeen, uint64_t *genOut) {
+    return h
+        ? ((BasicNetworkPlugin *) h)->readViewIfChanged(lastSeen, genOut)
+        : WaView{nullptr, 0};
+}
+WA_EXPORT int32_t WA_CALL   wa_get_tick_stats(void *h, WaTickStats *out) { return h ? ((BasicNetworkPlugin *) h)->tickStats(out) : WA_ERR_BAD_ARG; }
+WA_EXPORT int32_t WA_CALL   wa_get_cost_stats(void *h, WaCostStats *out) { return h ? ((BasicNetworkPlugin *) h)->costStats(out) : WA_ERR_BAD_ARG; }
+WA_EXPORT uint32_t WA_CALL  wa_get_view_format(void *h)           { return h ? ((BasicNetworkPlugin *) h)->viewFormat() : WA_FMT_JSON; }
+WA_EXPORT void WA_CALL      wa_set_demand(void *h, uint32_t demand)    { if (h) ((BasicNetworkPlugin *) h)->setDemand(demand); }
+WA_EXPORT int32_t WA_CALL   wa_tick_now(void *h, WaTickDoneFn done, void *user) { return h ? ((BasicNetworkPlugin *) h)->requestImmediateTick(done, user) : WA_ERR_BAD_ARG; }
+WA_EXPORT int32_t WA_CALL   wa_configure(void *h, const char *cfg) { return h ? ((BasicNetworkPlugin *) h)->configure(cfg) : WA_ERR_BAD_ARG; }
+WA_EXPORT int32_t WA_CALL   wa_request_async(void *h, const char *reqJsonUtf8, uint64_t reqId, WaRequestDoneFn done, void *user) {
+    return h
+        ? ((BasicNetworkPlugin *) h)->requestAsync(reqJsonUtf8, reqId, done, user)
+        : WA_ERR_BAD_ARG;
+}
 
 // Optional UI export
 WA_EXPORT QWidget* WA_CALL wa_create_widget(void* pluginHandle, QWidget* parent) {
@@ -21,26 +21,13 @@ static WaPluginInfo INFO{
 
 class DummyPlugin final : public BasePlugin {
 public:
-    explicit DummyPlugin(const char* configJsonUtf8)
-        : BasePlugin(INFO.defaultIntervalMs, configJsonUtf8)
+    explicit DummyPlugin(void* hostCtx, const char* configJsonUtf8)
+        : BasePlugin(INFO.defaultIntervalMs, configJsonUtf8, static_cast<WaHostApi*>(hostCtx))
         , log_(64) {}
 
 protected:
     bool onInit(QString& err) override {
-        // Read config with defaults
-        const QJsonObject& c = config();
-
-        nameTag_ = jsonString(c, "nameTag", "default");
-
-        const int maxLogEntries = jsonInt(c, "maxLogEntries", 64);
-        log_.setCapacity((size_t)qMax(1, maxLogEntries));
-
-        emitLogEvery_ = jsonInt(c, "emitLogEveryNTicks", 3);
-        if (emitLogEvery_ < 1) emitLogEvery_ = 1;
-
-        const double noise = jsonDouble(c, "noise", 0.25);
-        const int seedInt = jsonInt(c, "seed", 1337);
-        sampler_.configure(noise, (uint64_t)(seedInt < 0 ? -seedInt : seedInt));
+        readSettings(config());
 
         if (!sampler_.init(err)) {
             log_.push("error", "sampler.init failed", QJsonObject{{"err", err}});
@@ -52,6 +39,8 @@ protected:
                   QJsonObject{
                       {"nameTag", nameTag_},
                       {"intervalMs", (int)intervalMs()},
+                      {"sharedScheduler", usesHostScheduler()},
+                      {"requestsOnWorker", requestsOnWorker()},
                       {"noise", sampler_.noise()},
                       {"seed", (double)sampler_.seed()},
                   });
@@ -60,6 +49,19 @@ protected:
         return true;
     }
 
+    // Requests run on the tick thread here ("requestsOnWorker"), so the settings can
+    // be swapped between ticks without locking.
+    bool onReconfigure(const QJsonObject& cfg) override {
+        readSettings(cfg);
+        log_.push("info", "dummy reconfigured",
+                  QJsonObject{
+                      {"nameTag", nameTag_},
+                      {"noise", sampler_.noise()},
+                      {"seed", (double)sampler_.seed()},
+                  });
+        return true;
+    }
+
     void onStop() override {
         // Nothing external, but still log it
         log_.push("info", "dummy stopped", QJsonObject{{"ticks", (int)tickCount_}});
@@ -120,6 +122,13 @@ protected:
         return snap;
     }
 
+    // With "requestsOnWorker", bursts of these collapse into the last one per tick.
+    QString coalesceKey(const QJsonObject& req) const override {
+        const QString cmd = req.value("cmd").toString();
+        if (cmd == "ping" || cmd == "get_state" || cmd == "set_interval" || cmd == "set_noise") return cmd;
+        return {};
+    }
+
     QJsonObject onRequest(const QJsonObject& req) override {
         // Expected: { "cmd": "...", ... }
         const QString cmd = req.value("cmd").toString();
@@ -240,6 +249,21 @@ protected:
     }
 
 private:
+    // Config with defaults (onInit and onReconfigure)
+    void readSettings(const QJsonObject& c) {
+        nameTag_ = jsonString(c, "nameTag", "default");
+
+        const int maxLogEntries = jsonInt(c, "maxLogEntries", 64);
+        log_.setCapacity((size_t)qMax(1, maxLogEntries));
+
+        emitLogEvery_ = jsonInt(c, "emitLogEveryNTicks", 3);
+        if (emitLogEvery_ < 1) emitLogEvery_ = 1;
+
+        const double noise = jsonDouble(c, "noise", 0.25);
+        const int seedInt = jsonInt(c, "seed", 1337);
+        sampler_.configure(noise, (uint64_t)(seedInt < 0 ? -seedInt : seedInt));
+    }
+
     DummySampler sampler_{};
     RingLog log_;
 
@@ -258,8 +282,8 @@ private:
 // ---- C ABI exports ----
 WA_EXPORT const WaPluginInfo* WA_CALL wa_get_info() { return &INFO; }
 
-WA_EXPORT void* WA_CALL wa_create(void*, const char* cfg) {
-    return new DummyPlugin(cfg);
+WA_EXPORT void* WA_CALL wa_create(void* hostCtx, const char* cfg) {
+    return new DummyPlugin(hostCtx, cfg);
 }
 
 WA_EXPORT int32_t WA_CALL wa_init(void* h) {
@@ -296,3 +320,27 @@ WA_EXPORT WaView WA_CALL wa_request(void* h, const char* reqJsonUtf8) {
 WA_EXPORT WaView WA_CALL wa_read(void* h) {
     return h ? ((DummyPlugin*)h)->readView() : WaView{nullptr, 0};
 }
+WA_EXPORT WaView WA_CALL wa_read_if_changed(void* h, uint64_t lastSeen, uint64_t* genOut) {
+    return h ? ((DummyPlugin*)h)->readViewIfChanged(lastSeen, genOut) : WaView{nullptr, 0};
+}
+WA_EXPORT int32_t WA_CALL wa_get_tick_stats(void* h, WaTickStats* out) {
+    return h ? ((DummyPlugin*)h)->tickStats(out) : WA_ERR_BAD_ARG;
+}
+WA_EXPORT int32_t WA_CALL wa_get_cost_stats(void* h, WaCostStats* out) {
+    return h ? ((DummyPlugin*)h)->costStats(out) : WA_ERR_BAD_ARG;
+}
+WA_EXPORT uint32_t WA_CALL wa_get_view_format(void* h) {
+    return h ? ((DummyPlugin*)h)->viewFormat() : WA_FMT_JSON;
+}
+WA_EXPORT void WA_CALL wa_set_demand(void* h, uint32_t demand) {
+    if (h) ((DummyPlugin*)h)->setDemand(demand);
+}
+WA_EXPORT int32_t WA_CALL wa_tick_now(void* h, WaTickDoneFn done, void* user) {
+    return h ? ((DummyPlugin*)h)->requestImmediateTick(done, user) : WA_ERR_BAD_ARG;
+}
+WA_EXPORT int32_t WA_CALL wa_configure(void* h, const char* cfgJsonUtf8) {
+    return h ? ((DummyPlugin*)h)->configure(cfgJsonUtf8) : WA_ERR_BAD_ARG;
+}
+WA_EXPORT int32_t WA_CALL wa_request_async(void* h, const char* reqJsonUtf8, uint64_t reqId, WaRequestDoneFn done, void* user) {
+    return h ? ((DummyPlugin*)h)->requestAsync(reqJsonUtf8, reqId, done, user) : WA_ERR_BAD_ARG;
+}
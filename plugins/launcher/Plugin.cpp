@@ -20,7 +20,7 @@ static WaPluginInfo INFO{
 class LauncherPlugin final : public BasePlugin {
 public:
     explicit LauncherPlugin(void* hostCtx, const char* cfg)
-        : BasePlugin(INFO.defaultIntervalMs, cfg),
+        : BasePlugin(INFO.defaultIntervalMs, cfg, static_cast<WaHostApi*>(hostCtx)),
           hostApi_(static_cast<WaHostApi*>(hostCtx)) {
     }
 
@@ -112,6 +112,39 @@ WA_EXPORT WaView WA_CALL wa_read(void* handle) {
     if (!handle) return {nullptr, 0};
     return static_cast<LauncherPlugin*>(handle)->readView();
 }
+WA_EXPORT WaView WA_CALL wa_read_if_changed(void* handle, uint64_t lastSeen, uint64_t* genOut) {
+    if (!handle) return {nullptr, 0};
+    return static_cast<LauncherPlugin*>(handle)->readViewIfChanged(lastSeen, genOut);
+}
+WA_EXPORT int32_t WA_CALL wa_get_tick_stats(void* handle, WaTickStats* out) {
+    if (!handle) return WA_ERR_BAD_ARG;
+    return static_cast<LauncherPlugin*>(handle)->tickStats(out);
+}
+WA_EXPORT int32_t WA_CALL wa_get_cost_stats(void* handle, WaCostStats* out) {
+    if (!handle) return WA_ERR_BAD_ARG;
+    return static_cast<LauncherPlugin*>(handle)->costStats(out);
+}
+WA_EXPORT uint32_t WA_CALL wa_get_view_format(void* handle) {
+    if (!handle) return WA_FMT_JSON;
+    return static_cast<LauncherPlugin*>(handle)->viewFormat();
+}
+WA_EXPORT void WA_CALL wa_set_demand(void* handle, uint32_t demand) {
+    if (!handle) return;
+    static_cast<LauncherPlugin*>(handle)->setDemand(demand);
+}
+WA_EXPORT int32_t WA_CALL wa_tick_now(void* handle, WaTickDoneFn done, void* user) {
+    if (!handle) return WA_ERR_BAD_ARG;
+    return static_cast<LauncherPlugin*>(handle)->requestImmediateTick(done, user);
+}
+WA_EXPORT int32_t WA_CALL wa_configure(void* handle, const char* cfgJsonUtf8) {
+    if (!handle) return WA_ERR_BAD_ARG;
+    return static_cast<LauncherPlugin*>(handle)->configure(cfgJsonUtf8);
+}
+WA_EXPORT int32_t WA_CALL wa_request_async(void* handle, const char* reqJsonUtf8, uint64_t reqId,
+                                           WaRequestDoneFn done, void* user) {
+    if (!handle) return WA_ERR_BAD_ARG;
+    return static_cast<LauncherPlugin*>(handle)->requestAsync(reqJsonUtf8, reqId, done, user);
+}
 
 WA_EXPORT WaView WA_CALL wa_request(void* handle, const char* reqJsonUtf8) {
     if (!handle) return {nullptr, 0};
@@ -511,7 +511,8 @@ LauncherUi::LauncherUi(WaHostApi *api, QWidget *parent)
 
     connect(btnSave_, &QPushButton::clicked, this, [this]() {
         if (!saveToDisk()) return;
-        if (api_ && api_->plugin_restart) api_->plugin_restart(api_->user, kPluginId);
+        if (api_ && api_->apiVersion >= 4 && api_->plugin_reconfigure) api_->plugin_reconfigure(api_->user, kPluginId);
+        else if (api_ && api_->plugin_restart) api_->plugin_restart(api_->user, kPluginId);
         loadFromDisk();
         refreshStatus();
     });
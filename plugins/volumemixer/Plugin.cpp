@@ -1,6 +1,7 @@
 #include "BasePlugin.h"
 
-#include <QJsonArray>
+#include <charconv>
+
 #include <QJsonObject>
 #include <QString>
 
@@ -20,10 +21,10 @@ static WaPluginInfo INFO{
     1000
 };
 
-class VolumeMixerPlugin final : public BasePlugin {
+class VolumeMixerPlugin final : public StreamingPlugin {
 public:
     explicit VolumeMixerPlugin(void *hostCtx, const char *configJsonUtf8)
-        : BasePlugin(INFO.defaultIntervalMs, configJsonUtf8),
+        : StreamingPlugin(INFO.defaultIntervalMs, configJsonUtf8, static_cast<WaHostApi*>(hostCtx)),
           hostApi_(static_cast<WaHostApi *>(hostCtx)) {
     }
 
@@ -36,28 +37,38 @@ protected:
         return true;
     }
 
+    // The filter is only read by ticks, so a new one can be swapped in between them.
+    bool onReconfigure(const QJsonObject &cfg) override {
+        mixer.init(cfg);
+        return true;
+    }
+
     void onStop() override {
     }
 
-    QJsonObject onTick() override {
+    bool onTickWrite(SnapshotWriter &w) override {
         std::vector<MixerApp> data = mixer.update();
 
-        QJsonArray apps = {};
+        w.beginObject();
+        w.field("ok", true);
+        w.key("apps").beginArray();
         for (auto &app: data) {
-            apps.append(QJsonObject{
-                {"pid", QString::number(app.pid)},
-                {"type", app.type},
-                {"name", QString::fromStdWString(app.name)},
-                {"volume", app.volume},
-                {"muted", app.muted}
-            });
+            // pid is sent as a string (dashboard compares it against request args)
+            char pid[24];
+            const auto r = std::to_chars(pid, pid + sizeof(pid), app.pid);
+
+            w.beginObject()
+                .field("pid", std::string_view(pid, r.ptr - pid))
+                .field("type", app.type)
+                .field("name", std::wstring_view(app.name))
+                .field("volume", app.volume)
+                .field("muted", app.muted)
+                .endObject();
         }
+        w.endArray();
+        w.endObject();
 
-        QJsonObject snap;
-        snap.insert("ok", true);
-        snap.insert("apps", apps);
-
-        return snap;
+        return true;
     }
 
 
@@ -118,6 +129,22 @@ WA_EXPORT WaView WA_CALL    wa_read(void *h) {
         ? ((VolumeMixerPlugin *) h)->readView()
         : WaView{nullptr, 0};
 }
+WA_EXPORT WaView WA_CALL    wa_read_if_changed(void *h, uint64_t lastSeen, uint64_t *genOut) {
+    return h
+        ? ((VolumeMixerPlugin *) h)->readViewIfChanged(lastSeen, genOut)
+        : WaView{nullptr, 0};
+}
+WA_EXPORT int32_t WA_CALL   wa_get_tick_stats(void *h, WaTickStats *out) { return h ? ((VolumeMixerPlugin *) h)->tickStats(out) : WA_ERR_BAD_ARG; }
+WA_EXPORT int32_t WA_CALL   wa_get_cost_stats(void *h, WaCostStats *out) { return h ? ((VolumeMixerPlugin *) h)->costStats(out) : WA_ERR_BAD_ARG; }
+WA_EXPORT uint32_t WA_CALL  wa_get_view_format(void *h)           { return h ? ((VolumeMixerPlugin *) h)->viewFormat() : WA_FMT_JSON; }
+WA_EXPORT void WA_CALL      wa_set_demand(void *h, uint32_t demand)    { if (h) ((VolumeMixerPlugin *) h)->setDemand(demand); }
+WA_EXPORT int32_t WA_CALL   wa_tick_now(void *h, WaTickDoneFn done, void *user) { return h ? ((VolumeMixerPlugin *) h)->requestImmediateTick(done, user) : WA_ERR_BAD_ARG; }
+WA_EXPORT int32_t WA_CALL   wa_configure(void *h, const char *cfg) { return h ? ((VolumeMixerPlugin *) h)->configure(cfg) : WA_ERR_BAD_ARG; }
+WA_EXPORT int32_t WA_CALL   wa_request_async(void *h, const char *reqJsonUtf8, uint64_t reqId, WaRequestDoneFn done, void *user) {
+    return h
+        ? ((VolumeMixerPlugin *) h)->requestAsync(reqJsonUtf8, reqId, done, user)
+        : WA_ERR_BAD_ARG;
+}
 
 // Optional UI export
 WA_EXPORT QWidget* WA_CALL wa_create_widget(void* pluginHandle, QWidget* parent) {
@@ -0,0 +1,40 @@
+#include "AuthSecret.h"
+
+#include <algorithm>
+
+#include <QDir>
+#include <QFile>
+#include <QRandomGenerator>
+#include <QSaveFile>
+
+QString AuthSecret::path() {
+    // %USER_HOME%/winagent.secret
+    return QDir::home().absoluteFilePath("winagent.secret");
+}
+
+QString AuthSecret::generate() {
+    const int n = QRandomGenerator::global()->bounded(0, 1000000);
+    return QString("%1").arg(n, 6, 10, QChar('0'));
+}
+
+bool AuthSecret::write(const QString &s) {
+    QSaveFile f(path());
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+    f.write(s.toUtf8());
+    f.write("\n");
+    return f.commit();
+}
+
+QString AuthSecret::loadOrCreate() {
+    QFile f(path());
+    if (f.exists() && f.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        const QString s = QString::fromUtf8(f.readAll()).trimmed();
+        if (s.size() == 6 && std::all_of(s.begin(), s.end(), [](QChar c) { return c.isDigit(); })) {
+            return s;
+        }
+    }
+
+    const QString s = generate();
+    write(s);
+    return s;
+}
@@ -1,19 +1,147 @@
 #include "BasePlugin.h"
 
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <new>
+
+#include <QCborMap>
+#include <QCborValue>
 #include <QJsonDocument>
 #include <QJsonParseError>
 
-BasePlugin::BasePlugin(uint32_t defaultIntervalMs, const char* configJsonUtf8) {
+// Catch-up never runs more than this many missed ticks back to back.
+static constexpr int64_t kMaxCatchUpTicks = 8;
+
+static uint32_t histBucket(uint64_t us) {
+    return std::min<uint32_t>((uint32_t)std::bit_width(us >> 6), WA_TICK_HIST_BUCKETS - 1);
+}
+
+static void storeMax(std::atomic<uint64_t>& slot, uint64_t v) {
+    uint64_t cur = slot.load(std::memory_order_relaxed);
+    while (v > cur && !slot.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {}
+}
+
+// CPU time (user + kernel) of the calling thread.
+static uint64_t threadCpuUs() {
+#if defined(_WIN32)
+    FILETIME created, exited, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &created, &exited, &kernel, &user)) return 0;
+    const auto ticks = [](const FILETIME& f) {
+        return ((uint64_t)f.dwHighDateTime << 32) | f.dwLowDateTime;  // 100 ns units
+    };
+    return (ticks(kernel) + ticks(user)) / 10;
+#else
+    timespec ts{};
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) return 0;
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+#endif
+}
+
+// Allocation accounting (opt-in per plugin: WA_COUNT_ALLOCS). Replaces operator new
+// of the plugin DLL only, which Windows binds per module. Elsewhere a replacement in
+// a shared object would interpose the host's, so the flag is ignored there.
+#if defined(WA_COUNT_ALLOCS) && defined(WA_BUILDING_PLUGIN) && defined(_WIN32)
+static thread_local uint64_t tlAllocs = 0;
+static thread_local uint64_t tlAllocBytes = 0;
+
+void* operator new(std::size_t n) {
+    tlAllocs++;
+    tlAllocBytes += n;
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+static constexpr uint32_t kCostFlags = WA_COST_ALLOCS;
+static uint64_t threadAllocs() { return tlAllocs; }
+static uint64_t threadAllocBytes() { return tlAllocBytes; }
+#else
+static constexpr uint32_t kCostFlags = 0;
+static uint64_t threadAllocs() { return 0; }
+static uint64_t threadAllocBytes() { return 0; }
+#endif
+
+static BasePlugin::OverrunPolicy parseOverrunPolicy(const QString& s) {
+    const QString v = s.trimmed().toLower();
+    if (v == "catchup" || v == "catch_up") return BasePlugin::OverrunPolicy::CatchUp;
+    if (v == "stretch") return BasePlugin::OverrunPolicy::Stretch;
+    return BasePlugin::OverrunPolicy::Skip;
+}
+
+struct BasePlugin::QueuedRequest {
+    QueuedRequest* next = nullptr;
+    QByteArray json;
+    // wa_request_async completion, or (done == nullptr) a wa_request waiting on reply
+    uint64_t id = 0;
+    WaRequestDoneFn done = nullptr;
+    void* doneUser = nullptr;
+    std::promise<QJsonObject> reply;
+};
+
+// Head value of a closed request queue (never dereferenced). Pushes fail while
+// closed, so nothing can be left behind when the tick thread is gone.
+BasePlugin::QueuedRequest* BasePlugin::queueClosed() {
+    static char tag;
+    return reinterpret_cast<QueuedRequest*>(&tag);
+}
+
+static BasePlugin::IdlePolicy parseIdlePolicy(const QString& s) {
+    const QString v = s.trimmed().toLower();
+    if (v == "slow") return BasePlugin::IdlePolicy::Slow;
+    if (v == "off" || v == "none") return BasePlugin::IdlePolicy::Off;
+    return BasePlugin::IdlePolicy::Park;
+}
+
+static bool hostHasScheduler(const WaHostApi* host) {
+    return host && host->apiVersion >= 2 &&
+           host->sched_register && host->sched_unregister &&
+           host->sched_set_interval && host->sched_set_active;
+}
+
+struct BasePlugin::PendingConfig {
+    QJsonObject cfg;
+    std::promise<int32_t> result;
+};
+
+// Config keys applied by BasePlugin itself (or only read by the host); changing
+// only these never involves onReconfigure().
+static constexpr const char* kBaseConfigKeys[] = {
+    "intervalMs", "overrunPolicy", "idle", "idleIntervalMs", "callBudgetMs",
+    "workerProcess", "workerRingKiB"
+};
+// Keys that choose the threading/encoding setup of a handle.
+static constexpr const char* kFixedConfigKeys[] = {
+    "sharedScheduler", "requestsOnWorker", "snapshotFormat"
+};
+
+BasePlugin::BasePlugin(uint32_t defaultIntervalMs, const char* configJsonUtf8, WaHostApi* host)
+    : host_(host) {
+    defaultIntervalMs_ = defaultIntervalMs;
     intervalMs_.store(defaultIntervalMs);
+    reqHead_.store(queueClosed());
 
     QString err;
     config_ = parseObjectUtf8(configJsonUtf8, &err);
-    if (!config_.isEmpty()) {
-        const auto v = config_.value("intervalMs");
-        if (v.isDouble()) {
-            const int ms = v.toInt();
-            if (ms > 0) intervalMs_.store((uint32_t)ms);
-        }
+    applyBaseConfig(config_);
+    useHostScheduler_ = config_.value("sharedScheduler").toBool(false) && hostHasScheduler(host_);
+    requestsOnWorker_ = config_.value("requestsOnWorker").toBool(false);
+    if (config_.value("snapshotFormat").toString().compare("cbor", Qt::CaseInsensitive) == 0) {
+        format_ = WA_FMT_CBOR;
     }
 
     // Default snapshot
@@ -50,12 +178,36 @@ int32_t BasePlugin::start() {
         return WA_ERR_BAD_STATE;
     }
 
+    state_.store(State::Running);
+    resyncDeadline_.store(true);
+
+    if (requestsOnWorker_) {
+        QueuedRequest* closed = queueClosed();
+        reqHead_.compare_exchange_strong(closed, nullptr);
+    }
+
+    if (useHostScheduler_) {
+        if (!schedTask_.load()) {
+            stopRequested_.store(false);
+            // Due immediately: the first tick runs even when parked.
+            const uint64_t task = host_->sched_register(host_->user, &BasePlugin::schedTick, this, effectiveIntervalMs());
+            if (!task) {
+                closeRequestQueue();
+                state_.store(st);
+                return WA_ERR;
+            }
+            schedTask_.store(task);
+        } else {
+            updateSchedActive();
+        }
+        return WA_OK;
+    }
+
     if (!worker_.joinable()) {
         stopRequested_.store(false);
         worker_ = std::thread(&BasePlugin::threadMain, this);
     }
 
-    state_.store(State::Running);
     cv_.notify_all();
     return WA_OK;
 }
@@ -64,6 +216,7 @@ int32_t BasePlugin::pause() {
     auto st = state_.load();
     if (st == State::Running) {
         state_.store(State::Paused);
+        updateSchedActive();
         cv_.notify_all();
         return WA_OK;
     }
@@ -73,7 +226,9 @@ int32_t BasePlugin::pause() {
 int32_t BasePlugin::resume() {
     auto st = state_.load();
     if (st == State::Paused) {
+        resyncDeadline_.store(true);
         state_.store(State::Running);
+        updateSchedActive();
         cv_.notify_all();
         return WA_OK;
     }
@@ -87,6 +242,20 @@ int32_t BasePlugin::stop() {
     cv_.notify_all();
 
     if (worker_.joinable()) worker_.join();
+    if (const uint64_t task = schedTask_.exchange(0)) {
+        // Blocks until an in-progress tick on the host pool has returned.
+        host_->sched_unregister(host_->user, task);
+    }
+    // The tick thread is gone: answer what it did not get to.
+    closeRequestQueue();
+    stopRequestThread();
+    {
+        std::lock_guard<std::mutex> g(tickWaitMu_);
+        tickFiring_.swap(tickWaiters_);
+    }
+    finishTickWaiters(0);
+    // No tick thread left to race with: a configure() that came too late is applied here.
+    applyPendingConfig();
 
     state_.store(State::Stopped);
     onStop();
@@ -96,36 +265,348 @@ int32_t BasePlugin::stop() {
 void BasePlugin::setIntervalMs(uint32_t ms) {
     if (ms == 0) return;
     intervalMs_.store(ms);
+    if (const uint64_t task = schedTask_.load()) host_->sched_set_interval(host_->user, task, effectiveIntervalMs());
     cv_.notify_all();
 }
 
-WaView BasePlugin::readView() {
-    std::lock_guard<std::mutex> g(snapMu_);
-    readBuf_ = latest_; // stable buffer for caller
-    if (readBuf_.isEmpty()) readBuf_ = "{}";
-    return { readBuf_.constData(), (uint32_t)readBuf_.size() };
+void BasePlugin::applyBaseConfig(const QJsonObject& cfg) {
+    const int ms = cfg.value("intervalMs").toInt(0);
+    intervalMs_.store(ms > 0 ? (uint32_t)ms : defaultIntervalMs_);
+    overrunPolicy_.store(parseOverrunPolicy(cfg.value("overrunPolicy").toString()));
+
+    std::lock_guard<std::mutex> g(demandMu_);
+    idlePolicy_.store(parseIdlePolicy(cfg.value("idle").toString()));
+    const int idleMs = cfg.value("idleIntervalMs").toInt(0);
+    idleIntervalMs_.store(idleMs > 0 ? (uint32_t)idleMs : 10000);
 }
 
-WaView BasePlugin::requestView(const char* requestJsonUtf8) {
+int32_t BasePlugin::configure(const char* configJsonUtf8) {
     QString err;
-    QJsonObject req = parseObjectUtf8(requestJsonUtf8, &err);
-    QJsonObject resp;
+    const QJsonObject cfg = parseObjectUtf8(configJsonUtf8, &err);
+    if (!err.isEmpty()) return WA_ERR_BAD_ARG;
 
-    if (!err.isEmpty()) {
-        resp = QJsonObject{{"ok", false}, {"error", "bad_json"}, {"details", err}};
+    std::lock_guard<std::mutex> serial(configMu_);
+    PendingConfig pc{cfg, {}};
+    std::future<int32_t> result = pc.result.get_future();
+    {
+        // Same hand-off rule as requestImmediateTick(): stop() flushes under this lock.
+        std::lock_guard<std::mutex> g(tickWaitMu_);
+        const State st = state_.load();
+        const bool ticking = !stopRequested_.load() && (st == State::Running || st == State::Paused);
+        if (!ticking) return applyConfig(cfg);  // no tick thread to race with
+        pendingConfig_.store(&pc);
+    }
+
+    if (useHostScheduler_) {
+        // Also runs an inactive (paused/parked) task once.
+        const uint64_t task = schedTask_.load();
+        if (task && host_->sched_wake) host_->sched_wake(host_->user, task);
     } else {
-        resp = onRequest(req);
+        { std::lock_guard<std::mutex> g(cvMu_); }
+        cv_.notify_all();
     }
+    return result.get();
+}
 
-    QJsonDocument doc(resp);
+void BasePlugin::applyPendingConfig() {
+    PendingConfig* pc = nullptr;
     {
-        std::lock_guard<std::mutex> g(snapMu_);
-        replyBuf_ = doc.toJson(QJsonDocument::Compact);
-        if (replyBuf_.isEmpty()) replyBuf_ = "{}";
+        std::lock_guard<std::mutex> g(tickWaitMu_);
+        pc = pendingConfig_.exchange(nullptr);
+    }
+    if (pc) pc->result.set_value(applyConfig(pc->cfg));
+}
+
+int32_t BasePlugin::applyConfig(const QJsonObject& cfg) {
+    for (const char* k: kFixedConfigKeys) {
+        if (cfg.value(k) != config_.value(k)) return WA_ERR_BAD_STATE;
+    }
+
+    bool pluginKeys = false;
+    const auto isBaseKey = [](const QString& k) {
+        return std::any_of(std::begin(kBaseConfigKeys), std::end(kBaseConfigKeys),
+                           [&k](const char* b) { return k == QString(b); });
+    };
+    for (const QJsonObject* o: std::initializer_list<const QJsonObject*>{&cfg, &config_}) {
+        for (auto it = o->begin(); it != o->end() && !pluginKeys; ++it) {
+            pluginKeys = !isBaseKey(it.key()) && cfg.value(it.key()) != config_.value(it.key());
+        }
+    }
+    if (pluginKeys && !onReconfigure(cfg)) return WA_ERR_BAD_STATE;
+
+    config_ = cfg;
+    applyBaseConfig(cfg);
+    if (const uint64_t task = schedTask_.load()) host_->sched_set_interval(host_->user, task, effectiveIntervalMs());
+    updateSchedActive();
+    { std::lock_guard<std::mutex> g(cvMu_); }
+    cv_.notify_all();
+    return WA_OK;
+}
+
+bool BasePlugin::idle() const noexcept {
+    return idlePolicy_.load() != IdlePolicy::Off &&
+           (demand_.load() & (WA_DEMAND_SUBSCRIBED | WA_DEMAND_GUI)) == 0;
+}
+
+uint32_t BasePlugin::effectiveIntervalMs() const noexcept {
+    const uint32_t ms = intervalMs_.load();
+    if (idlePolicy_.load() == IdlePolicy::Slow && idle()) return std::max(ms, idleIntervalMs_.load());
+    return ms;
+}
+
+void BasePlugin::setDemand(uint32_t demandFlags) {
+    std::lock_guard<std::mutex> g(demandMu_);
+    const bool wasIdle = idle();
+    demand_.store(demandFlags);
+    if (idle() == wasIdle) return;
+
+    // Coming back: tick right away and restart the grid from now.
+    if (wasIdle) resyncDeadline_.store(true);
+
+    if (const uint64_t task = schedTask_.load()) {
+        host_->sched_set_interval(host_->user, task, effectiveIntervalMs());
+        const bool active = state_.load() == State::Running && !parked();
+        host_->sched_set_active(host_->user, task, active ? 1 : 0);
+        if (active && wasIdle && host_->sched_wake) host_->sched_wake(host_->user, task);
+    }
+
+    { std::lock_guard<std::mutex> lk(cvMu_); }
+    cv_.notify_all();
+}
+
+void BasePlugin::updateSchedActive() {
+    const uint64_t task = schedTask_.load();
+    if (!task) return;
+    std::lock_guard<std::mutex> g(demandMu_);
+    // A pending resync (start/resume) still gets its one tick while parked.
+    const bool active = state_.load() == State::Running && (!parked() || resyncDeadline_.load());
+    host_->sched_set_active(host_->user, task, active ? 1 : 0);
+}
+
+WaView BasePlugin::readView() {
+    // No copy, no lock shared with the worker: just take a reference to the
+    // published snapshot and hold it until the next readView() call.
+    readPin_ = latest_.load(std::memory_order_acquire);
+    if (!readPin_) return emptyView();
+    return { readPin_->bytes.constData(), (uint32_t)readPin_->bytes.size() };
+}
+
+WaView BasePlugin::emptyView() const noexcept {
+    // An empty object in the handle's format (0xA0 = CBOR map of length 0).
+    if (format_ == WA_FMT_CBOR) return { "\xA0", 1 };
+    return { "{}", 2 };
+}
+
+WaView BasePlugin::readViewIfChanged(uint64_t lastSeenGeneration, uint64_t* generationOut) {
+    SnapshotPtr snap = latest_.load(std::memory_order_acquire);
+    const uint64_t gen = snap ? snap->generation : 0;
+    if (generationOut) *generationOut = gen;
+    if (gen == lastSeenGeneration) return { nullptr, 0 };
+
+    readPin_ = std::move(snap);
+    if (!readPin_) return emptyView();
+    return { readPin_->bytes.constData(), (uint32_t)readPin_->bytes.size() };
+}
+
+int32_t BasePlugin::requestImmediateTick(WaTickDoneFn done, void* doneUser) {
+    {
+        // stop() sets stopRequested_ before it flushes the waiters under this lock,
+        // so an accepted waiter is always completed.
+        std::lock_guard<std::mutex> g(tickWaitMu_);
+        if (stopRequested_.load() || state_.load() != State::Running) return WA_ERR_BAD_STATE;
+        if (done) tickWaiters_.push_back(TickWaiter{done, doneUser});
+    }
+    tickNow_.store(true);
+
+    if (useHostScheduler_) {
+        const uint64_t task = schedTask_.load();
+        if (task && host_->sched_wake) host_->sched_wake(host_->user, task);
+    } else {
+        { std::lock_guard<std::mutex> g(cvMu_); }
+        cv_.notify_all();
+    }
+    return WA_OK;
+}
+
+void BasePlugin::finishTickWaiters(uint64_t generation) {
+    for (const TickWaiter& w: tickFiring_) w.done(w.doneUser, generation);
+    tickFiring_.clear();
+}
+
+uint64_t BasePlugin::snapshotGeneration() const noexcept {
+    const SnapshotPtr snap = latest_.load(std::memory_order_acquire);
+    return snap ? snap->generation : 0;
+}
+
+QJsonObject BasePlugin::handleRequest(const char* jsonUtf8) {
+    QString err;
+    QJsonObject req = parseObjectUtf8(jsonUtf8, &err);
+    if (!err.isEmpty()) {
+        return QJsonObject{{"ok", false}, {"error", "bad_json"}, {"details", err}};
+    }
+    return onRequest(req);
+}
+
+WaView BasePlugin::requestView(const char* requestJsonUtf8) {
+    QJsonObject resp;
+    bool answered = false;
+    if (requestsOnWorker_) {
+        auto* r = new QueuedRequest;
+        r->json = QByteArray(requestJsonUtf8 ? requestJsonUtf8 : "");
+        std::future<QJsonObject> reply = r->reply.get_future();
+        if (pushRequest(r)) {
+            resp = reply.get();
+            answered = true;
+        } else {
+            delete r; // no tick thread (not started or stopped): answer inline
+        }
+    }
+    if (!answered) resp = handleRequest(requestJsonUtf8);
+
+    QByteArray bytes = encodeObject(resp);
+    {
+        std::lock_guard<std::mutex> g(replyMu_);
+        replyBuf_ = std::move(bytes);
         return { replyBuf_.constData(), (uint32_t)replyBuf_.size() };
     }
 }
 
+int32_t BasePlugin::requestAsync(const char* requestJsonUtf8, uint64_t requestId,
+                                 WaRequestDoneFn done, void* doneUser) {
+    if (!done) return WA_ERR_BAD_ARG;
+
+    if (requestsOnWorker_) {
+        auto* r = new QueuedRequest;
+        r->json = QByteArray(requestJsonUtf8 ? requestJsonUtf8 : "");
+        r->id = requestId;
+        r->done = done;
+        r->doneUser = doneUser;
+        if (pushRequest(r)) return WA_OK;
+        delete r; // no tick thread: use the request thread below
+    }
+
+    std::lock_guard<std::mutex> g(requestMu_);
+    if (requestsClosed_) return WA_ERR_BAD_STATE;
+
+    requests_.push_back(AsyncRequest{QByteArray(requestJsonUtf8 ? requestJsonUtf8 : ""), requestId, done, doneUser});
+    if (!requestThread_.joinable()) {
+        requestThread_ = std::thread(&BasePlugin::requestThreadMain, this);
+    }
+    requestCv_.notify_one();
+    return WA_OK;
+}
+
+void BasePlugin::requestThreadMain() {
+    std::unique_lock<std::mutex> lk(requestMu_);
+    while (true) {
+        requestCv_.wait(lk, [&] { return requestsClosed_ || !requests_.empty(); });
+        if (requests_.empty()) return; // closed and drained
+
+        AsyncRequest r = std::move(requests_.front());
+        requests_.pop_front();
+        const bool closing = requestsClosed_;
+        lk.unlock();
+
+        // Requests still queued at stop() are answered without running the handler.
+        const QJsonObject resp = closing
+            ? QJsonObject{{"ok", false}, {"error", "stopped"}}
+            : handleRequest(r.json.constData());
+        const QByteArray bytes = encodeObject(resp);
+        r.done(r.doneUser, r.id, WaView{bytes.constData(), (uint32_t)bytes.size()});
+
+        lk.lock();
+    }
+}
+
+void BasePlugin::stopRequestThread() {
+    {
+        std::lock_guard<std::mutex> g(requestMu_);
+        requestsClosed_ = true;
+    }
+    requestCv_.notify_all();
+    // Every accepted request gets its callback before stop() returns.
+    if (requestThread_.joinable()) requestThread_.join();
+}
+
+bool BasePlugin::hasQueuedRequests() const noexcept {
+    QueuedRequest* head = reqHead_.load(std::memory_order_acquire);
+    return head && head != queueClosed();
+}
+
+bool BasePlugin::pushRequest(QueuedRequest* r) {
+    QueuedRequest* head = reqHead_.load(std::memory_order_relaxed);
+    do {
+        if (head == queueClosed()) return false;
+        r->next = head;
+    } while (!reqHead_.compare_exchange_weak(head, r, std::memory_order_release, std::memory_order_relaxed));
+
+    if (useHostScheduler_) {
+        requestWake_.store(true);
+        const uint64_t task = schedTask_.load();
+        if (task && host_->sched_wake) host_->sched_wake(host_->user, task);
+    } else {
+        // Taking cvMu_ orders the push before the worker's predicate check (no lost wakeup).
+        { std::lock_guard<std::mutex> g(cvMu_); }
+        cv_.notify_all();
+    }
+    return true;
+}
+
+void BasePlugin::completeRequest(QueuedRequest* r, const QJsonObject& resp) const {
+    if (r->done) {
+        const QByteArray bytes = encodeObject(resp);
+        r->done(r->doneUser, r->id, WaView{bytes.constData(), (uint32_t)bytes.size()});
+    } else {
+        r->reply.set_value(resp);
+    }
+    delete r;
+}
+
+void BasePlugin::drainRequests() {
+    // Take the whole stack; it is LIFO, so reverse it into batch_ for FIFO order.
+    QueuedRequest* head = reqHead_.load(std::memory_order_acquire);
+    do {
+        if (!head || head == queueClosed()) return;
+    } while (!reqHead_.compare_exchange_weak(head, nullptr, std::memory_order_acquire, std::memory_order_relaxed));
+
+    batch_.clear();
+    for (QueuedRequest* r = head; r; r = r->next) batch_.push_back(BatchItem{r});
+    std::reverse(batch_.begin(), batch_.end());
+
+    // Parse once and find the last request per coalesce key; it answers all of them.
+    std::vector<QString> keys(batch_.size());
+    for (size_t i = 0; i < batch_.size(); i++) {
+        BatchItem& it = batch_[i];
+        it.req = parseObjectUtf8(it.r->json.constData(), &it.parseError);
+        it.answerFrom = i;
+        if (it.parseError.isEmpty()) keys[i] = coalesceKey(it.req);
+        for (size_t j = 0; j < i && !keys[i].isEmpty(); j++) {
+            if (keys[j] == keys[i]) batch_[j].answerFrom = i;
+        }
+    }
+
+    for (size_t i = 0; i < batch_.size(); i++) {
+        BatchItem& it = batch_[i];
+        if (it.answerFrom != i) continue;
+        it.reply = it.parseError.isEmpty()
+            ? onRequest(it.req)
+            : QJsonObject{{"ok", false}, {"error", "bad_json"}, {"details", it.parseError}};
+    }
+
+    for (BatchItem& it: batch_) completeRequest(it.r, batch_[it.answerFrom].reply);
+    batch_.clear();
+}
+
+void BasePlugin::closeRequestQueue() {
+    QueuedRequest* head = reqHead_.exchange(queueClosed(), std::memory_order_acq_rel);
+    if (!head || head == queueClosed()) return;
+
+    std::vector<QueuedRequest*> left;
+    for (QueuedRequest* r = head; r; r = r->next) left.push_back(r);
+    const QJsonObject resp{{"ok", false}, {"error", "stopped"}};
+    for (auto it = left.rbegin(); it != left.rend(); ++it) completeRequest(*it, resp);
+}
+
 QJsonObject BasePlugin::onRequest(const QJsonObject& req) {
     Q_UNUSED(req);
     return QJsonObject{{"ok", true}};
@@ -133,34 +614,262 @@ QJsonObject BasePlugin::onRequest(const QJsonObject& req) {
 
 void BasePlugin::threadMain() {
     while (!stopRequested_.load()) {
-        // Wait until Running (or stop)
+        // Wait until Running (or stop); queued requests are served while paused too
         {
             std::unique_lock<std::mutex> lk(cvMu_);
             cv_.wait(lk, [&]{
-                return stopRequested_.load() || state_.load() == State::Running;
+                return stopRequested_.load() || state_.load() == State::Running || hasQueuedRequests() ||
+                       pendingConfig_.load();
             });
         }
         if (stopRequested_.load()) break;
 
-        // Tick
-        QJsonObject obj = onTick();
-        setSnapshotObject(obj);
+        applyPendingConfig();
+        drainRequests();
+        if (state_.load() != State::Running) continue;
+
+        // A request wake-up ahead of the deadline does not tick. While parked only
+        // the first tick after start/resume runs. Immediate ticks run off the grid.
+        if (resyncDeadline_.load() || (!parked() && Clock::now() >= deadline_)) tickOnce();
+        else if (tickNow_.load()) tickOnce(false);
 
-        // Sleep interval or wake on pause/stop/interval change
-        const auto ms = intervalMs_.load();
         std::unique_lock<std::mutex> lk(cvMu_);
-        cv_.wait_for(lk, std::chrono::milliseconds(ms), [&]{
-            return stopRequested_.load() || state_.load() != State::Running;
+        if (parked()) {
+            // Nobody consumes the data: sleep until demand returns
+            cv_.wait(lk, [&]{
+                return stopRequested_.load() || state_.load() != State::Running || !parked() ||
+                       hasQueuedRequests() || tickNow_.load() || pendingConfig_.load();
+            });
+            continue;
+        }
+        // Sleep until the next deadline (fixed rate) or wake on pause/stop/request/demand
+        cv_.wait_until(lk, deadline_, [&]{
+            return stopRequested_.load() || state_.load() != State::Running || hasQueuedRequests() ||
+                   resyncDeadline_.load() || tickNow_.load() || parked() || pendingConfig_.load();
         });
         // if paused -> loop will wait for Running again
     }
 }
 
+bool BasePlugin::tickOnce(bool onGrid) {
+    const auto start = Clock::now();
+    if (onGrid && resyncDeadline_.exchange(false)) deadline_ = start;
+
+    // Any tick that starts from here on is fresh enough for pending waiters.
+    tickNow_.store(false);
+    {
+        std::lock_guard<std::mutex> g(tickWaitMu_);
+        tickFiring_.swap(tickWaiters_);
+    }
+
+    const uint64_t jitterUs = onGrid && start > deadline_
+        ? (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(start - deadline_).count()
+        : 0;
+
+    const uint64_t cpu0 = threadCpuUs();
+    const uint64_t allocs0 = threadAllocs();
+    const uint64_t allocBytes0 = threadAllocBytes();
+
+    if (!publishStreamed()) {
+        QJsonObject obj = onTick();
+        setSnapshotObject(obj);
+    }
+    if (!tickFiring_.empty()) finishTickWaiters(snapshotGeneration());
+
+    const auto end = Clock::now();
+    const uint64_t tickUs = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+    const uint64_t cpuUs = threadCpuUs() - cpu0;
+    const uint64_t allocs = threadAllocs() - allocs0;
+    stats_.tickCpuUs.fetch_add(cpuUs, std::memory_order_relaxed);
+    stats_.lastTickCpuUs.store(cpuUs, std::memory_order_relaxed);
+    storeMax(stats_.maxTickCpuUs, cpuUs);
+    stats_.allocs.fetch_add(allocs, std::memory_order_relaxed);
+    stats_.allocBytes.fetch_add(threadAllocBytes() - allocBytes0, std::memory_order_relaxed);
+    stats_.lastTickAllocs.store(allocs, std::memory_order_relaxed);
+
+    stats_.ticks.fetch_add(1, std::memory_order_relaxed);
+    stats_.lastTickUs.store(tickUs, std::memory_order_relaxed);
+    storeMax(stats_.maxTickUs, tickUs);
+    stats_.tickUsHist[histBucket(tickUs)].fetch_add(1, std::memory_order_relaxed);
+    if (!onGrid) return false;
+
+    storeMax(stats_.maxJitterUs, jitterUs);
+    stats_.jitterUsHist[histBucket(jitterUs)].fetch_add(1, std::memory_order_relaxed);
+    return advanceDeadline(end);
+}
+
+bool BasePlugin::advanceDeadline(Clock::time_point now) {
+    const auto interval = std::chrono::milliseconds(effectiveIntervalMs());
+    const auto next = deadline_ + interval;
+    if (next > now) {
+        deadline_ = next;
+        return false;
+    }
+
+    stats_.overruns.fetch_add(1, std::memory_order_relaxed);
+    const int64_t missed = (now - next) / interval + 1;
+
+    switch (overrunPolicy_.load()) {
+        case OverrunPolicy::CatchUp:
+            if (missed <= kMaxCatchUpTicks) {
+                deadline_ = next; // already due -> runs right away
+                return true;
+            }
+            // Too far behind: drop the backlog instead of bursting.
+            [[fallthrough]];
+        case OverrunPolicy::Skip:
+            stats_.skipped.fetch_add((uint64_t)missed, std::memory_order_relaxed);
+            deadline_ = next + missed * interval;
+            return false;
+        case OverrunPolicy::Stretch:
+            deadline_ = now + interval;
+            return false;
+    }
+    return false;
+}
+
+void WA_CALL BasePlugin::schedTick(void* self) {
+    auto* p = static_cast<BasePlugin*>(self);
+    if (p->stopRequested_.load()) return;
+
+    // Runs woken for requests only tick if the next deadline is (nearly) due;
+    // the pool's own grid may be slightly ahead of deadline_, hence the slack.
+    // Immediate ticks ahead of the grid run off it (tickOnce(false)).
+    const bool requestWake = p->requestWake_.exchange(false);
+    p->applyPendingConfig();
+    p->drainRequests();
+    if (p->state_.load() != State::Running) return;
+    const bool resync = p->resyncDeadline_.load();
+    const bool tickNow = p->tickNow_.load();
+    if (!resync && p->parked()) {
+        if (tickNow) p->tickOnce(false);
+        return;
+    }
+    if ((requestWake || tickNow) && !resync &&
+        Clock::now() + std::chrono::milliseconds(p->effectiveIntervalMs() / 2) < p->deadline_) {
+        if (tickNow) p->tickOnce(false);
+        return;
+    }
+
+    // The host pool keeps its own fixed-rate grid; catch-up is requested with a wake.
+    if (p->tickOnce() && p->host_->sched_wake) {
+        p->host_->sched_wake(p->host_->user, p->schedTask_.load());
+    }
+    // Parked after the start/resume tick: leave the pool alone until demand returns.
+    if (p->parked()) p->updateSchedActive();
+}
+
+int32_t BasePlugin::tickStats(WaTickStats* out) const {
+    if (!out) return WA_ERR_BAD_ARG;
+    out->ticks = stats_.ticks.load(std::memory_order_relaxed);
+    out->overruns = stats_.overruns.load(std::memory_order_relaxed);
+    out->skipped = stats_.skipped.load(std::memory_order_relaxed);
+    out->lastTickUs = stats_.lastTickUs.load(std::memory_order_relaxed);
+    out->maxTickUs = stats_.maxTickUs.load(std::memory_order_relaxed);
+    out->maxJitterUs = stats_.maxJitterUs.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < WA_TICK_HIST_BUCKETS; i++) {
+        out->tickUsHist[i] = stats_.tickUsHist[i].load(std::memory_order_relaxed);
+        out->jitterUsHist[i] = stats_.jitterUsHist[i].load(std::memory_order_relaxed);
+    }
+    return WA_OK;
+}
+
+int32_t BasePlugin::costStats(WaCostStats* out) const {
+    if (!out) return WA_ERR_BAD_ARG;
+    *out = WaCostStats{};
+    out->flags = kCostFlags;
+    out->tickCpuUs = stats_.tickCpuUs.load(std::memory_order_relaxed);
+    out->lastTickCpuUs = stats_.lastTickCpuUs.load(std::memory_order_relaxed);
+    out->maxTickCpuUs = stats_.maxTickCpuUs.load(std::memory_order_relaxed);
+    out->allocs = stats_.allocs.load(std::memory_order_relaxed);
+    out->allocBytes = stats_.allocBytes.load(std::memory_order_relaxed);
+    out->lastTickAllocs = stats_.lastTickAllocs.load(std::memory_order_relaxed);
+    return WA_OK;
+}
+
 void BasePlugin::setSnapshotObject(const QJsonObject& obj) {
-    QJsonDocument doc(obj);
-    std::lock_guard<std::mutex> g(snapMu_);
-    latest_ = doc.toJson(QJsonDocument::Compact);
-    if (latest_.isEmpty()) latest_ = "{}";
+    // Serialize outside of any lock, then publish with a single atomic swap.
+    auto snap = std::make_shared<Snapshot>();
+    snap->bytes = encodeObject(obj);
+    snap->generation = nextGeneration_.fetch_add(1, std::memory_order_relaxed);
+    latest_.store(std::move(snap), std::memory_order_release);
+}
+
+bool BasePlugin::publishStreamed() {
+    std::shared_ptr<Snapshot> snap = takeRecycledSnapshot();
+    writer_.reset(&snap->bytes, format_);
+    if (!onTickWrite(writer_)) return false;
+    if (!writer_.finish()) {
+        setSnapshotObject(QJsonObject{{"ok", false}, {"error", "bad_snapshot"}});
+        return true;
+    }
+
+    snap->generation = nextGeneration_.fetch_add(1, std::memory_order_relaxed);
+    // The old snapshot comes back through recycleSnapshot() once its last reader lets go.
+    latest_.store(std::move(snap), std::memory_order_release);
+    return true;
+}
+
+std::shared_ptr<BasePlugin::Snapshot> BasePlugin::takeRecycledSnapshot() {
+    std::unique_ptr<Snapshot> snap;
+    {
+        std::lock_guard<std::mutex> g(recycleMu_);
+        if (!recycled_.empty()) {
+            snap = std::move(recycled_.back());
+            recycled_.pop_back();
+        }
+        // recycleSnapshot() must not allocate.
+        if (recycled_.capacity() < kMaxSpareSnapshots) recycled_.reserve(kMaxSpareSnapshots);
+        if (freeBlocks_.blocks.capacity() < 2 * kMaxSpareSnapshots) freeBlocks_.blocks.reserve(2 * kMaxSpareSnapshots);
+    }
+    if (!snap) snap = std::make_unique<Snapshot>();
+    return std::shared_ptr<Snapshot>(snap.release(), SnapshotRecycler{this}, ControlBlockAlloc<Snapshot>(this));
+}
+
+void BasePlugin::recycleSnapshot(Snapshot* snap) noexcept {
+    // Runs in the thread that dropped the last reference, after its last use of the bytes.
+    std::unique_ptr<Snapshot> owned(snap);
+    std::lock_guard<std::mutex> g(recycleMu_);
+    if (recycled_.size() < recycled_.capacity()) recycled_.push_back(std::move(owned));
+}
+
+void* BasePlugin::allocControlBlock(size_t bytes) {
+    {
+        std::lock_guard<std::mutex> g(recycleMu_);
+        if (bytes == freeBlocks_.bytes && !freeBlocks_.blocks.empty()) {
+            void* block = freeBlocks_.blocks.back();
+            freeBlocks_.blocks.pop_back();
+            return block;
+        }
+    }
+    return ::operator new(bytes);
+}
+
+void BasePlugin::freeControlBlock(void* block, size_t bytes) noexcept {
+    {
+        std::lock_guard<std::mutex> g(recycleMu_);
+        if (freeBlocks_.bytes == 0) freeBlocks_.bytes = bytes;
+        if (bytes == freeBlocks_.bytes && freeBlocks_.blocks.size() < freeBlocks_.blocks.capacity()) {
+            freeBlocks_.blocks.push_back(block);
+            return;
+        }
+    }
+    ::operator delete(block);
+}
+
+BasePlugin::BlockCache::~BlockCache() {
+    for (void* block: blocks) ::operator delete(block);
+}
+
+QByteArray BasePlugin::encodeObject(const QJsonObject& obj) const {
+    if (format_ == WA_FMT_CBOR) {
+        // Qt keeps QJsonObject in a CBOR container, so this skips the text round trip.
+        return QCborMap::fromJsonObject(obj).toCborValue().toCbor();
+    }
+    QByteArray bytes = QJsonDocument(obj).toJson(QJsonDocument::Compact);
+    if (bytes.isEmpty()) bytes = "{}";
+    return bytes;
 }
 
 QJsonObject BasePlugin::parseObjectUtf8(const char* jsonUtf8, QString* errOut) {
@@ -180,3 +889,290 @@ QJsonObject BasePlugin::parseObjectUtf8(const char* jsonUtf8, QString* errOut) {
     }
     return doc.object();
 }
+
+// =========================
+// SnapshotWriter
+// =========================
+void SnapshotWriter::reset(QByteArray* out, WaFormat format) {
+    out_ = out;
+    out_->resize(0); // Qt 6 never shrinks capacity on resize
+    format_ = format;
+    depth_ = 0;
+    ok_ = true;
+    rootDone_ = false;
+    afterKey_ = false;
+}
+
+bool SnapshotWriter::beforeValue() {
+    if (!out_ || !ok_) return false;
+    if (depth_ == 0) {
+        if (rootDone_) {
+            ok_ = false;
+            return false;
+        }
+        return true;
+    }
+    if (isObject_[depth_]) {
+        // Object members need a key first.
+        if (!afterKey_) {
+            ok_ = false;
+            return false;
+        }
+        afterKey_ = false;
+        return true;
+    }
+    if (format_ == WA_FMT_JSON && needComma_[depth_]) out_->append(',');
+    needComma_[depth_] = true;
+    return true;
+}
+
+void SnapshotWriter::beginContainer(char jsonOpen, uint8_t cborOpen) {
+    if (!beforeValue()) return;
+    if (depth_ == kMaxDepth) {
+        ok_ = false;
+        return;
+    }
+    if (format_ == WA_FMT_JSON) out_->append(jsonOpen);
+    else out_->append((char)cborOpen);
+    depth_++;
+    needComma_[depth_] = false;
+    isObject_[depth_] = jsonOpen == '{';
+}
+
+void SnapshotWriter::endContainer(char jsonClose) {
+    if (!out_ || !ok_) return;
+    if (depth_ == 0 || afterKey_ || isObject_[depth_] != (jsonClose == '}')) {
+        ok_ = false;
+        return;
+    }
+    if (format_ == WA_FMT_JSON) out_->append(jsonClose);
+    else out_->append((char)0xff); // "break" ends an indefinite-length item
+    depth_--;
+    if (depth_ == 0) rootDone_ = true;
+}
+
+SnapshotWriter& SnapshotWriter::beginObject() { beginContainer('{', 0xbf); return *this; }
+SnapshotWriter& SnapshotWriter::endObject()   { endContainer('}'); return *this; }
+SnapshotWriter& SnapshotWriter::beginArray()  { beginContainer('[', 0x9f); return *this; }
+SnapshotWriter& SnapshotWriter::endArray()    { endContainer(']'); return *this; }
+
+SnapshotWriter& SnapshotWriter::key(std::string_view utf8) {
+    if (!out_ || !ok_) return *this;
+    if (depth_ == 0 || !isObject_[depth_] || afterKey_) {
+        ok_ = false;
+        return *this;
+    }
+    if (format_ == WA_FMT_JSON) {
+        if (needComma_[depth_]) out_->append(',');
+        jsonString(utf8);
+        out_->append(':');
+    } else {
+        cborHead(3, utf8.size());
+        out_->append(utf8.data(), (qsizetype)utf8.size());
+    }
+    needComma_[depth_] = true;
+    afterKey_ = true;
+    return *this;
+}
+
+SnapshotWriter& SnapshotWriter::null() {
+    if (!beforeValue()) return *this;
+    if (format_ == WA_FMT_JSON) out_->append("null", 4);
+    else out_->append((char)0xf6);
+    if (depth_ == 0) rootDone_ = true;
+    return *this;
+}
+
+SnapshotWriter& SnapshotWriter::writeBool(bool v) {
+    if (!beforeValue()) return *this;
+    if (format_ == WA_FMT_JSON) {
+        if (v) out_->append("true", 4);
+        else out_->append("false", 5);
+    } else {
+        out_->append((char)(v ? 0xf5 : 0xf4));
+    }
+    if (depth_ == 0) rootDone_ = true;
+    return *this;
+}
+
+SnapshotWriter& SnapshotWriter::writeInt(int64_t v) {
+    if (v >= 0) return writeUInt((uint64_t)v);
+    if (!beforeValue()) return *this;
+    if (format_ == WA_FMT_JSON) {
+        char buf[24];
+        const auto r = std::to_chars(buf, buf + sizeof(buf), v);
+        out_->append(buf, (qsizetype)(r.ptr - buf));
+    } else {
+        cborHead(1, (uint64_t)(-(v + 1)));
+    }
+    if (depth_ == 0) rootDone_ = true;
+    return *this;
+}
+
+SnapshotWriter& SnapshotWriter::writeUInt(uint64_t v) {
+    if (!beforeValue()) return *this;
+    if (format_ == WA_FMT_JSON) {
+        char buf[24];
+        const auto r = std::to_chars(buf, buf + sizeof(buf), v);
+        out_->append(buf, (qsizetype)(r.ptr - buf));
+    } else {
+        cborHead(0, v);
+    }
+    if (depth_ == 0) rootDone_ = true;
+    return *this;
+}
+
+SnapshotWriter& SnapshotWriter::writeDouble(double v) {
+    if (!std::isfinite(v)) return null(); // like QJsonValue: no NaN/inf in JSON
+    if (!beforeValue()) return *this;
+    if (format_ == WA_FMT_JSON) {
+        char buf[32];
+        const auto r = std::to_chars(buf, buf + sizeof(buf), v); // shortest round-trip form
+        out_->append(buf, (qsizetype)(r.ptr - buf));
+    } else {
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        char buf[9];
+        buf[0] = (char)0xfb;
+        for (int i = 0; i < 8; i++) buf[1 + i] = (char)(bits >> (56 - 8 * i));
+        out_->append(buf, 9);
+    }
+    if (depth_ == 0) rootDone_ = true;
+    return *this;
+}
+
+SnapshotWriter& SnapshotWriter::value(std::string_view utf8) {
+    if (!beforeValue()) return *this;
+    if (format_ == WA_FMT_JSON) {
+        jsonString(utf8);
+    } else {
+        cborHead(3, utf8.size());
+        out_->append(utf8.data(), (qsizetype)utf8.size());
+    }
+    if (depth_ == 0) rootDone_ = true;
+    return *this;
+}
+
+// Decodes one code point from UTF-16 (or UTF-32 for a 4-byte wchar_t).
+template <typename CharT>
+static char32_t nextCodePoint(const CharT* s, size_t n, size_t& i) {
+    const char32_t c = (char32_t)s[i++];
+    if constexpr (sizeof(CharT) == 2) {
+        if (c >= 0xd800 && c <= 0xdbff && i < n) {
+            const char32_t lo = (char32_t)s[i];
+            if (lo >= 0xdc00 && lo <= 0xdfff) {
+                i++;
+                return 0x10000 + ((c - 0xd800) << 10) + (lo - 0xdc00);
+            }
+        }
+        if (c >= 0xd800 && c <= 0xdfff) return 0xfffd; // unpaired surrogate
+    }
+    return c > 0x10ffff ? 0xfffd : c;
+}
+
+static int encodeUtf8(char32_t cp, char* out) {
+    if (cp < 0x80) {
+        out[0] = (char)cp;
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = (char)(0xc0 | (cp >> 6));
+        out[1] = (char)(0x80 | (cp & 0x3f));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = (char)(0xe0 | (cp >> 12));
+        out[1] = (char)(0x80 | ((cp >> 6) & 0x3f));
+        out[2] = (char)(0x80 | (cp & 0x3f));
+        return 3;
+    }
+    out[0] = (char)(0xf0 | (cp >> 18));
+    out[1] = (char)(0x80 | ((cp >> 12) & 0x3f));
+    out[2] = (char)(0x80 | ((cp >> 6) & 0x3f));
+    out[3] = (char)(0x80 | (cp & 0x3f));
+    return 4;
+}
+
+template <typename CharT>
+void SnapshotWriter::unicodeString(const CharT* s, size_t n) {
+    if (!beforeValue()) return;
+    char buf[4];
+
+    if (format_ == WA_FMT_JSON) {
+        out_->append('"');
+        for (size_t i = 0; i < n;) {
+            const int len = encodeUtf8(nextCodePoint(s, n, i), buf);
+            if (len == 1) jsonEscaped(buf[0]);
+            else out_->append(buf, len);
+        }
+        out_->append('"');
+    } else {
+        // CBOR needs the byte length up front: measure, then encode.
+        uint64_t bytes = 0;
+        for (size_t i = 0; i < n;) bytes += (uint64_t)encodeUtf8(nextCodePoint(s, n, i), buf);
+        cborHead(3, bytes);
+        for (size_t i = 0; i < n;) out_->append(buf, encodeUtf8(nextCodePoint(s, n, i), buf));
+    }
+    if (depth_ == 0) rootDone_ = true;
+}
+
+SnapshotWriter& SnapshotWriter::value(std::wstring_view text) {
+    unicodeString(text.data(), text.size());
+    return *this;
+}
+
+SnapshotWriter& SnapshotWriter::value(const QString& text) {
+    unicodeString(text.utf16(), (size_t)text.size());
+    return *this;
+}
+
+void SnapshotWriter::cborHead(uint8_t major, uint64_t arg) {
+    char buf[9];
+    const char m = (char)(major << 5);
+    if (arg < 24) {
+        out_->append((char)(m | (char)arg));
+        return;
+    }
+    int n;
+    if (arg <= 0xff) { buf[0] = (char)(m | 24); n = 1; }
+    else if (arg <= 0xffff) { buf[0] = (char)(m | 25); n = 2; }
+    else if (arg <= 0xffffffffull) { buf[0] = (char)(m | 26); n = 4; }
+    else { buf[0] = (char)(m | 27); n = 8; }
+    for (int i = 0; i < n; i++) buf[1 + i] = (char)(arg >> (8 * (n - 1 - i)));
+    out_->append(buf, 1 + n);
+}
+
+void SnapshotWriter::jsonEscaped(char c) {
+    static constexpr char kHex[] = "0123456789abcdef";
+    const unsigned char u = (unsigned char)c;
+    if (u >= 0x20 && c != '"' && c != '\\') {
+        out_->append(c);
+        return;
+    }
+    switch (c) {
+        case '"':  out_->append("\\\"", 2); break;
+        case '\\': out_->append("\\\\", 2); break;
+        case '\n': out_->append("\\n", 2); break;
+        case '\r': out_->append("\\r", 2); break;
+        case '\t': out_->append("\\t", 2); break;
+        default: {
+            const char esc[6] = {'\\', 'u', '0', '0', kHex[u >> 4], kHex[u & 0xf]};
+            out_->append(esc, 6);
+        }
+    }
+}
+
+void SnapshotWriter::jsonString(std::string_view utf8) {
+    out_->append('"');
+    size_t run = 0; // start of the current run that needs no escaping
+    for (size_t i = 0; i < utf8.size(); i++) {
+        const unsigned char c = (unsigned char)utf8[i];
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        out_->append(utf8.data() + run, (qsizetype)(i - run));
+        jsonEscaped((char)c);
+        run = i + 1;
+    }
+    out_->append(utf8.data() + run, (qsizetype)(utf8.size() - run));
+    out_->append('"');
+}
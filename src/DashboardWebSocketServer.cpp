@@ -1,6 +1,9 @@
 #include "DashboardWebSocketServer.h"
 
+#include <QCborMap>
+#include <QCborValue>
 #include <QFile>
+#include <QJsonArray>
 #include <QSslKey>
 #include <QThread>
 #include <QMetaObject>
@@ -8,8 +11,11 @@
 #include <QUrlQuery>
 #include <QWebSocketProtocol>
 
+#include <algorithm>
+
 #include "Logger.h"
 #include "PluginManager.h"
+#include "WireFormat.h"
 
 DashboardWebSocketServer::DashboardWebSocketServer(
     PluginManager *plugins,
@@ -17,13 +23,30 @@ DashboardWebSocketServer::DashboardWebSocketServer(
                        m_plugins(plugins),
                        m_broadcastTimer(new QTimer(this)) {
     m_broadcastTimer->setTimerType(Qt::CoarseTimer);
-    m_broadcastTimer->setInterval(1000);
+    m_broadcastTimer->setInterval(kDefaultIntervalMs);
     connect(m_broadcastTimer, &QTimer::timeout, this, &DashboardWebSocketServer::broadcastTick);
 
     connect(this, &QWebSocketServer::newConnection, this, &DashboardWebSocketServer::onNewConnection);
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 4, 0)
+    // The client's order of preference decides; no subprotocol at all means JSON.
+    setSupportedSubprotocols({QString::fromLatin1(kCborSubprotocol), QString::fromLatin1(kJsonSubprotocol)});
+#endif
+}
+
+DashboardWebSocketServer::~DashboardWebSocketServer() {
+    {
+        std::lock_guard<std::mutex> g(m_liveness->mu);
+        m_liveness->alive = false;
+    }
+    stop();
 }
 
-DashboardWebSocketServer::~DashboardWebSocketServer() { stop(); }
+void DashboardWebSocketServer::postIfAlive(const std::shared_ptr<Liveness> &liveness,
+                                           DashboardWebSocketServer *server, std::function<void()> fn) {
+    std::lock_guard<std::mutex> g(liveness->mu);
+    if (liveness->alive) QMetaObject::invokeMethod(server, std::move(fn), Qt::QueuedConnection);
+}
 
 void DashboardWebSocketServer::start() {
     if (QThread::currentThread() != thread()) {
@@ -81,6 +104,16 @@ void DashboardWebSocketServer::stop() {
         client->deleteLater();
     }
     m_clients.clear();
+    m_clientState.clear();
+    m_moduleState.clear();
+    m_urgent.clear();
+    m_pending.reset();
+    m_broadcastAgain = false;
+    m_broadcastTimer->setInterval(kDefaultIntervalMs);
+    if (m_plugins) {
+        m_plugins->setClientDemand(0);
+        m_plugins->setHostSection("websocket", {});
+    }
 
     Logger::error("[WS] Server stopped!");
     emit stopped();
@@ -107,9 +140,25 @@ void DashboardWebSocketServer::onNewConnection() {
     Logger::debug("[WS] New connection from " + socket->peerAddress().toString());
 
     connect(socket, &QWebSocket::textMessageReceived, this, &DashboardWebSocketServer::onTextMessageReceived);
+    connect(socket, &QWebSocket::binaryMessageReceived, this, &DashboardWebSocketServer::onBinaryMessageReceived);
     connect(socket, &QWebSocket::disconnected, this, &DashboardWebSocketServer::onSocketDisconnected);
 
+    ClientState state;
+#if QT_VERSION >= QT_VERSION_CHECK(6, 4, 0)
+    if (socket->subprotocol() == QLatin1String(kCborSubprotocol)) state.encoding = Encoding::Cbor;
+#endif
+    // ?compress=deflate: large frames go out deflated (see sendFrame)
+    if (q.queryItemValue("compress") == "deflate" && FrameDeflater::available()) {
+        state.deflater = std::make_shared<FrameDeflater>();
+    }
+    // ?delta=1: the client applies merge patches (see broadcastJson)
+    state.mergePatch = q.queryItemValue("delta") == "1";
+    state.subscriptions.insert(QStringLiteral("*"), Subscription{});
+
     m_clients.insert(socket);
+    m_clientState.insert(socket, state);
+    // Wakes parked plugins so the keyframe is fresh soon after.
+    applySubscriptions();
     emit clientConnected();
 }
 
@@ -120,7 +169,10 @@ void DashboardWebSocketServer::onSocketDisconnected() {
     Logger::debug("[WS] Socket disconnected from " + socket->peerAddress().toString());
 
     m_clients.remove(socket);
+    m_clientState.remove(socket);
+    if (m_pending) m_pending->clients.remove(socket);
     socket->deleteLater();
+    applySubscriptions();
 
     emit clientDisconnected();
 }
@@ -135,7 +187,34 @@ void DashboardWebSocketServer::onTextMessageReceived(const QString &message) {
         return;
     }
 
-    QJsonObject root = doc.object();
+    handleMessage(qobject_cast<QWebSocket *>(sender()), doc.object());
+}
+
+// CBOR clients may send their messages as binary frames (same shape as the JSON ones).
+void DashboardWebSocketServer::onBinaryMessageReceived(const QByteArray &message) {
+    QCborParserError err;
+    const QCborValue cv = QCborValue::fromCbor(message, &err);
+
+    if (err.error != QCborError::NoError || !cv.isMap()) {
+        Logger::error("[WS] Invalid CBOR message: " + err.errorString());
+        return;
+    }
+
+    handleMessage(qobject_cast<QWebSocket *>(sender()), cv.toMap().toJsonObject());
+}
+
+void DashboardWebSocketServer::handleMessage(QWebSocket *socket, const QJsonObject &root) {
+    // {"event":"resync"}: the client lost track of its modules and wants a keyframe.
+    const QString eventName = root.value("event").toString();
+    if (eventName == "resync") {
+        const auto it = m_clientState.find(socket);
+        if (it != m_clientState.end()) it->needsKeyframe = true;
+        return;
+    }
+    if (eventName == "subscribe") {
+        handleSubscribe(socket, root.value("modules"));
+        return;
+    }
 
     handleModuleRequest(root);
 }
@@ -144,6 +223,215 @@ void DashboardWebSocketServer::broadcastTick() {
     broadcastJson();
 }
 
+// {"event":"subscribe","modules":{"basiccpu":{"minIntervalMs":250},"media":{},"*":{"maxIntervalMs":5000}}}
+// or "modules":["basiccpu","media"] (default rates). Replaces the previous subscription.
+void DashboardWebSocketServer::handleSubscribe(QWebSocket *socket, const QJsonValue &modules) {
+    const auto it = m_clientState.find(socket);
+    if (it == m_clientState.end()) return;
+    ClientState &c = *it;
+
+    QHash<QString, Subscription> subscriptions;
+    if (modules.isArray()) {
+        for (const QJsonValue &v: modules.toArray()) {
+            if (v.isString()) subscriptions.insert(v.toString(), Subscription{});
+        }
+    } else if (modules.isObject()) {
+        const QJsonObject o = modules.toObject();
+        for (auto mit = o.begin(); mit != o.end(); ++mit) {
+            const QJsonObject rates = mit.value().toObject();
+            Subscription sub;
+            sub.minIntervalMs = std::clamp<qint64>(rates.value("minIntervalMs").toInteger(kDefaultIntervalMs),
+                                                   kMinIntervalMs, kMaxIntervalMs);
+            const qint64 maxMs = rates.value("maxIntervalMs").toInteger(0);
+            if (maxMs > 0) sub.maxIntervalMs = std::clamp<qint64>(maxMs, sub.minIntervalMs, kMaxIntervalMs);
+            subscriptions.insert(mit.key(), sub);
+        }
+    } else {
+        Logger::warn("[WS] Invalid subscribe message from " + socket->peerAddress().toString());
+        return;
+    }
+
+    // Dropped modules are forgotten, so subscribing again starts with a full snapshot.
+    const bool all = subscriptions.contains("*");
+    for (auto vit = c.versions.begin(); vit != c.versions.end();) {
+        if (!all && !subscriptions.contains(vit.key())) {
+            c.sentAtMs.remove(vit.key());
+            vit = c.versions.erase(vit);
+        } else {
+            ++vit;
+        }
+    }
+    c.subscriptions = subscriptions;
+    applySubscriptions();
+}
+
+DashboardWebSocketServer::Subscription *DashboardWebSocketServer::subscriptionFor(ClientState &client,
+                                                                                 const QString &module) {
+    auto it = client.subscriptions.find(module);
+    // The host module changes every second: only clients naming it get it.
+    if (it == client.subscriptions.end() && module != QLatin1String(PluginManager::kHostModuleId)) {
+        it = client.subscriptions.find(QStringLiteral("*"));
+    }
+    return it == client.subscriptions.end() ? nullptr : &*it;
+}
+
+void DashboardWebSocketServer::applySubscriptions() {
+    qint64 intervalMs = kDefaultIntervalMs;
+    bool allModules = false;
+    QSet<QString> modules;
+    for (const ClientState &c: std::as_const(m_clientState)) {
+        for (auto it = c.subscriptions.begin(); it != c.subscriptions.end(); ++it) {
+            intervalMs = std::min(intervalMs, it.value().minIntervalMs);
+            if (it.key() == "*") allModules = true;
+            else modules.insert(it.key());
+        }
+    }
+    if (m_broadcastTimer->interval() != intervalMs) m_broadcastTimer->setInterval((int) intervalMs);
+    if (m_plugins) m_plugins->setClientDemand((int) m_clients.size(), allModules ? nullptr : &modules);
+}
+
+static void appendJsonString(QByteArray &out, const QString &s) {
+    out += '"';
+    for (const char c: s.toUtf8()) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if ((unsigned char) c < 0x20) out += QByteArray("\\u00") + QByteArray::number((int) c, 16).rightJustified(2, '0');
+                else out += c;
+        }
+    }
+    out += '"';
+}
+
+bool DashboardWebSocketServer::modulePatch(const ModuleState &module, quint64 baseVersion, QJsonObject &patch) {
+    const QJsonObject *from = nullptr;
+    const QJsonObject *to = nullptr;
+    for (const auto &r: module.recent) {
+        if (r.first == baseVersion) from = &r.second;
+        if (r.first == module.version) to = &r.second;
+    }
+    if (!from || !to) return false;
+    return WireFormat::mergePatch(*from, *to, patch);
+}
+
+// {"event":"update","payload":{"timestamp":..,"keyframe":true,"modules":{..},"patch":{..},
+//  "stale":[..],"removed":[..]}}
+// Module snapshots are already validated JSON objects and are copied in verbatim.
+QByteArray DashboardWebSocketServer::buildUpdate(qint64 timestamp, bool keyframe,
+                                                 const std::vector<UpdatePart> &parts,
+                                                 const QStringList &stale,
+                                                 const QStringList &removed) {
+    qsizetype size = 112;
+    for (const auto &p: parts) size += p.data.size() + p.id->size() + 8;
+
+    QByteArray out;
+    out.reserve(size);
+    out += R"({"event":"update","payload":{"timestamp":)";
+    out += QByteArray::number(timestamp);
+    if (keyframe) out += R"(,"keyframe":true)";
+
+    // Full snapshots under "modules" (always present), patches under "patch".
+    for (const bool patches: {false, true}) {
+        bool first = true;
+        for (const auto &p: parts) {
+            if (p.patch != patches) continue;
+            out += first ? (patches ? R"(,"patch":{)" : R"(,"modules":{)") : ",";
+            first = false;
+            appendJsonString(out, *p.id);
+            out += ':';
+            out += p.data;
+        }
+        if (!first) out += '}';
+        else if (!patches) out += R"(,"modules":{})";
+    }
+
+    for (const bool isRemoved: {false, true}) {
+        bool first = true;
+        for (const auto &id: isRemoved ? removed : stale) {
+            out += first ? (isRemoved ? R"(,"removed":[)" : R"(,"stale":[)") : ",";
+            first = false;
+            appendJsonString(out, id);
+        }
+        if (!first) out += ']';
+    }
+    out += "}}";
+    return out;
+}
+
+using WireFormat::cborHead;
+using WireFormat::cborText;
+
+static void cborText(QByteArray &out, const char *s) {
+    cborText(out, QString::fromLatin1(s));
+}
+
+// Same document as buildUpdate() in CBOR; the modules are spliced in pre-encoded.
+QByteArray DashboardWebSocketServer::buildUpdateCbor(qint64 timestamp, bool keyframe,
+                                                     const std::vector<UpdatePart> &parts,
+                                                     const QStringList &stale,
+                                                     const QStringList &removed) {
+    qsizetype size = 64;
+    qsizetype patchCount = 0;
+    for (const auto &p: parts) {
+        size += p.data.size() + p.id->size() + 4;
+        if (p.patch) patchCount++;
+    }
+    const qsizetype fullCount = (qsizetype) parts.size() - patchCount;
+
+    QByteArray out;
+    out.reserve(size);
+    cborHead(out, 5, 2);
+    cborText(out, "event");
+    cborText(out, "update");
+    cborText(out, "payload");
+    cborHead(out, 5, 2 + (keyframe ? 1 : 0) + (patchCount ? 1 : 0) + (stale.isEmpty() ? 0 : 1) +
+                     (removed.isEmpty() ? 0 : 1));
+
+    cborText(out, "timestamp");
+    if (timestamp >= 0) cborHead(out, 0, (quint64) timestamp);
+    else cborHead(out, 1, (quint64) (-1 - timestamp));
+    if (keyframe) {
+        cborText(out, "keyframe");
+        out += char(0xf5); // true
+    }
+
+    for (const bool patches: {false, true}) {
+        const qsizetype count = patches ? patchCount : fullCount;
+        if (patches && count == 0) continue;
+        cborText(out, patches ? "patch" : "modules");
+        cborHead(out, 5, (quint64) count);
+        for (const auto &p: parts) {
+            if (p.patch != patches) continue;
+            cborText(out, *p.id);
+            out += p.data;
+        }
+    }
+
+    if (!stale.isEmpty()) {
+        cborText(out, "stale");
+        cborHead(out, 4, (quint64) stale.size());
+        for (const auto &id: stale) cborText(out, id);
+    }
+    if (!removed.isEmpty()) {
+        cborText(out, "removed");
+        cborHead(out, 4, (quint64) removed.size());
+        for (const auto &id: removed) cborText(out, id);
+    }
+    return out;
+}
+
+static QByteArray objectToCbor(const QJsonObject &object) {
+    return QCborMap::fromJsonObject(object).toCborValue().toCbor();
+}
+
+static QJsonObject cborToObject(const QByteArray &cbor) {
+    return QCborValue::fromCbor(cbor).toMap().toJsonObject();
+}
+
 void DashboardWebSocketServer::broadcastJson() {
     if (QThread::currentThread() != thread()) {
         QMetaObject::invokeMethod(this, "broadcastJson", Qt::QueuedConnection);
@@ -153,53 +441,362 @@ void DashboardWebSocketServer::broadcastJson() {
     if (m_clients.isEmpty())
         return;
 
-    //@formatter:off
-    QJsonObject root;       // Json root
-    QJsonObject payload;    // Payload root
-    QJsonObject timestamp;  // ├─ Current time  ⏱️
-    QJsonObject modules;    // └─ modules       🧩 (data from plugins)
-    //@formatter:on
-
-    payload["timestamp"] = QDateTime::currentSecsSinceEpoch();
-    if (m_plugins) {
-        modules = m_plugins->readAll();
-        payload["modules"] = modules;
+    // One broadcast at a time; a request meanwhile runs once the current one is out.
+    if (m_pending) {
+        m_broadcastAgain = true;
+        return;
     }
 
-    root["event"] = "update";
-    root["payload"] = payload;
+    // Which subscription entries are due, and so which modules need a read. A
+    // timer tick may come early by up to half an interval.
+    auto pending = std::make_unique<PendingBroadcast>();
+    pending->seq = ++m_broadcastSeq;
+    pending->nowMs = QDateTime::currentMSecsSinceEpoch();
+    pending->slackMs = m_broadcastTimer->interval() / 2;
+    QSet<QString> toRead = m_urgent;
+    for (auto cit = m_clientState.begin(); cit != m_clientState.end(); ++cit) {
+        ClientState &c = cit.value();
+        for (auto it = c.subscriptions.begin(); it != c.subscriptions.end(); ++it) {
+            Subscription &sub = it.value();
+            sub.due = c.needsKeyframe || pending->nowMs - sub.lastAtMs + pending->slackMs >= sub.minIntervalMs;
+            if (sub.due) toRead.insert(it.key());  // "*" reads every plugin
+        }
+        // A resync arriving while the reads run is kept for the next broadcast.
+        pending->clients.insert(cit.key(), std::exchange(c.needsKeyframe, false));
+    }
+    pending->urgent = std::exchange(m_urgent, {});
+
+    // The reads run on the plugin manager's pool; this thread keeps serving while
+    // they do, and sends once all are in or the read deadline fires.
+    const quint64 seq = pending->seq;
+    m_pending = std::move(pending);
+    if (!m_plugins || toRead.isEmpty()) {
+        sendBroadcast(seq);
+        return;
+    }
+    m_pending->read = m_plugins->beginReadAll(&toRead, [liveness = m_liveness, this, seq] {
+        postIfAlive(liveness, this, [this, seq] { sendBroadcast(seq); });
+    });
+    if (m_pending && m_pending->seq == seq) {
+        QTimer::singleShot((int) m_plugins->readDeadlineMs(), this, [this, seq] { sendBroadcast(seq); });
+    }
+}
 
-    QJsonDocument doc(root);
-    const QString json = QString::fromUtf8(doc.toJson(QJsonDocument::Compact));
+void DashboardWebSocketServer::sendBroadcast(quint64 seq) {
+    // Runs once per broadcast: whichever of read completion and deadline comes first.
+    if (!m_pending || m_pending->seq != seq) return;
+    const std::unique_ptr<PendingBroadcast> pending = std::move(m_pending);
+    const qint64 nowMs = pending->nowMs;
+    const qint64 slackMs = pending->slackMs;
+    const QSet<QString> &urgent = pending->urgent;
+
+    std::vector<PluginManager::ModuleJson> modules;
+    QSet<QString> live;
+    if (m_plugins && pending->read) modules = m_plugins->finishReadAll(pending->read, &live);
+
+    // Modules of stopped or unloaded plugins are forgotten; every client that has
+    // one hears so in its next update (payload.removed).
+    if (m_plugins && pending->read) {
+        for (auto it = m_moduleState.begin(); it != m_moduleState.end();) {
+            if (live.contains(it.key())) ++it;
+            else it = m_moduleState.erase(it);
+        }
+    }
 
-    if (m_plugins) {
-        m_plugins->markSent(modules.keys());
+    bool anyPatching = false;
+    for (const ClientState &c: std::as_const(m_clientState)) anyPatching |= c.mergePatch;
+
+    // A changed snapshot is a new module version. While some client takes patches
+    // the new bytes are parsed anyway (to diff against), so a change of bytes only
+    // (key order, number formatting) keeps the version; otherwise nothing is parsed.
+    // Versions are unique across modules, so a module that comes back never matches
+    // a version a client kept.
+    for (const auto &m: modules) {
+        ModuleState &ms = m_moduleState[m.id];
+        const bool isCbor = !m.cbor.isEmpty();
+        const auto parse = [](const QByteArray &json, const QByteArray &cbor) {
+            return cbor.isEmpty() ? QJsonDocument::fromJson(json).object() : cborToObject(cbor);
+        };
+        if (ms.version == 0 || (m.changed && (isCbor ? m.cbor != ms.cbor : m.json != ms.json))) {
+            QJsonObject next;
+            const bool diffable = anyPatching && !ms.recent.empty() && ms.recent.back().first == ms.version;
+            if (diffable) {
+                next = parse(m.json, m.cbor);
+                if (next == ms.recent.back().second) continue;
+            }
+            ms.version = ++m_moduleVersion;
+            ms.json = m.json;
+            ms.cbor = m.cbor;
+            if (diffable) {
+                ms.recent.emplace_back(ms.version, std::move(next));
+                if (ms.recent.size() > kPatchHistory) ms.recent.pop_front();
+            }
+        }
+        if (!anyPatching) {
+            ms.recent.clear();
+        } else if (ms.recent.empty() || ms.recent.back().first != ms.version) {
+            ms.recent.emplace_back(ms.version, parse(ms.json, ms.cbor));
+            if (ms.recent.size() > kPatchHistory) ms.recent.pop_front();
+        }
     }
-    emit broadcasted();
 
-    const auto clients = m_clients;
-    for (QWebSocket *socket: clients) {
-        if (!socket) continue;
-        if (socket->state() == QAbstractSocket::ConnectedState) {
-            socket->sendTextMessage(json);
+    // Every client gets the due modules of its subscription whose version it does
+    // not have yet: the snapshot, or a patch against its version. Clients in the
+    // same state share one message, and a patch is computed (and CBOR-encoded)
+    // once per (module, base version).
+    const qint64 timestamp = QDateTime::currentSecsSinceEpoch();
+    struct Message {
+        QByteArray bytes;
+        QString text;
+    };
+    QHash<QByteArray, Message> messages;
+    struct Patch {
+        bool ok = false;   // false: the full snapshot goes out
+        QJsonObject object;
+        QByteArray json;   // encoded on first use
+        QByteArray cbor;
+    };
+    QHash<QPair<QString, quint64>, Patch> patches;
+    QSet<QString> sent;
+
+    // Clients that connected while the reads ran wait for the next broadcast.
+    for (auto pit = pending->clients.begin(); pit != pending->clients.end(); ++pit) {
+        QWebSocket *socket = pit.key();
+        const auto cit = m_clientState.find(socket);
+        if (cit == m_clientState.end()) continue;
+        if (socket->state() != QAbstractSocket::ConnectedState) continue;
+        ClientState &c = *cit;
+        const bool keyframe = pit.value();
+
+        // Drain speed: what left the queue since the last broadcast. Only a queue
+        // that is still not empty tells the link's speed; an empty one keeps up.
+        const qint64 queued = socket->bytesToWrite();
+        if (queued == 0) {
+            c.drainBytesPerSec = 0;
+            c.holdUntilMs = 0;
+        } else if (c.sampleAtMs > 0 && nowMs > c.sampleAtMs) {
+            const qint64 drained = std::max<qint64>(0, c.queuedBytes + c.sentBytes - queued);
+            const double bps = (double) drained * 1000.0 / (double) (nowMs - c.sampleAtMs);
+            c.drainBytesPerSec = c.drainBytesPerSec > 0 ? 0.7 * c.drainBytesPerSec + 0.3 * bps : bps;
+        }
+        c.queuedBytes = queued;
+        c.maxQueuedBytes = std::max(c.maxQueuedBytes, queued);
+        c.sentBytes = 0;
+        c.sampleAtMs = nowMs;
+
+        // Latest wins: a client that is behind gets nothing now. Its module versions
+        // stay put, so its next update carries the state of that moment and
+        // superseded updates never pile up in the queue.
+        if (queued > kMaxQueuedBytes || nowMs + slackMs < c.holdUntilMs) {
+            c.updatesHeld++;
+            if (keyframe) c.needsKeyframe = true;
+            continue;
+        }
+
+        if (keyframe) {
+            c.versions.clear();
+            c.sentAtMs.clear();
+        }
+
+        std::vector<UpdatePart> parts;
+        QStringList stale;
+        QStringList removed;
+        for (auto vit = c.versions.begin(); vit != c.versions.end();) {
+            if (m_moduleState.contains(vit.key())) {
+                ++vit;
+                continue;
+            }
+            removed << vit.key();
+            c.sentAtMs.remove(vit.key());
+            vit = c.versions.erase(vit);
+        }
+        removed.sort();
+        const bool cbor = c.encoding == Encoding::Cbor;
+        QByteArray plan = cbor ? "c" : "j";
+        plan += keyframe ? 'k' : 'd';
+        for (const auto &m: modules) {
+            Subscription *sub = subscriptionFor(c, m.id);
+            if (!sub || !(sub->due || urgent.contains(m.id))) continue;
+            if (m.stale) stale << m.id;
+
+            ModuleState &ms = m_moduleState[m.id];
+            const quint64 have = c.versions.value(m.id, 0);
+            const bool refresh = sub->maxIntervalMs > 0 &&
+                                 nowMs - c.sentAtMs.value(m.id, 0) + slackMs >= sub->maxIntervalMs;
+            if (have == ms.version && !refresh) continue;
+
+            UpdatePart part{&m.id, {}, false};
+            if (c.mergePatch && have != 0 && have != ms.version) {
+                const auto key = qMakePair(m.id, have);
+                auto pit = patches.find(key);
+                if (pit == patches.end()) {
+                    Patch patch;
+                    patch.ok = modulePatch(ms, have, patch.object);
+                    pit = patches.insert(key, patch);
+                }
+                if (pit->ok && pit->object.isEmpty() && !refresh) {
+                    // Back to content the client already shows: only its version moves.
+                    c.versions.insert(m.id, ms.version);
+                    continue;
+                }
+                if (pit->ok && !pit->object.isEmpty()) {
+                    QByteArray &encoded = cbor ? pit->cbor : pit->json;
+                    if (encoded.isEmpty()) {
+                        encoded = cbor ? objectToCbor(pit->object)
+                                       : QJsonDocument(pit->object).toJson(QJsonDocument::Compact);
+                    }
+                    // Worth it only when smaller than the snapshot.
+                    if (encoded.size() < (ms.json.isEmpty() ? ms.cbor : ms.json).size()) {
+                        part.patch = true;
+                        part.data = encoded;
+                    }
+                }
+            }
+            if (!part.patch) {
+                // The other encoding comes from the parsed copy when there is one.
+                const QJsonObject *parsed = !ms.recent.empty() && ms.recent.back().first == ms.version
+                                                ? &ms.recent.back().second
+                                                : nullptr;
+                if (cbor && ms.cbor.isEmpty()) {
+                    ms.cbor = objectToCbor(parsed ? *parsed : QJsonDocument::fromJson(ms.json).object());
+                }
+                if (!cbor && ms.json.isEmpty()) {
+                    ms.json = QJsonDocument(parsed ? *parsed : cborToObject(ms.cbor)).toJson(QJsonDocument::Compact);
+                }
+                part.data = cbor ? ms.cbor : ms.json;
+            }
+            plan += ',';
+            plan += m.id.toUtf8();
+            if (part.patch) {
+                plan += '~';
+                plan += QByteArray::number(have);
+            }
+            parts.push_back(part);
+            c.versions.insert(m.id, ms.version);
+            c.sentAtMs.insert(m.id, nowMs);
+            sent.insert(m.id);
+        }
+        for (Subscription &sub: c.subscriptions) {
+            if (sub.due) sub.lastAtMs = nowMs;
+        }
+
+        // Nothing new: stay quiet unless the client would miss its heartbeat.
+        if (parts.empty() && stale.isEmpty() && removed.isEmpty() && !keyframe &&
+            nowMs - c.lastMessageMs + slackMs < kHeartbeatMs) {
+            continue;
+        }
+        c.lastMessageMs = nowMs;
+
+        if (!stale.isEmpty()) {
+            plan += '|';
+            plan += stale.join(',').toUtf8();
+        }
+        if (!removed.isEmpty()) {
+            plan += '-';
+            plan += removed.join(',').toUtf8();
+        }
+        auto mit = messages.find(plan);
+        if (mit == messages.end()) {
+            Message msg;
+            msg.bytes = cbor ? buildUpdateCbor(timestamp, keyframe, parts, stale, removed)
+                             : buildUpdate(timestamp, keyframe, parts, stale, removed);
+            mit = messages.insert(plan, msg);
+        }
+        const qint64 frameBytes = sendFrame(socket, c, mit->bytes, mit->text);
+        if (c.drainBytesPerSec > 0) {
+            c.holdUntilMs = nowMs + std::min<qint64>(kMaxHoldMs, (qint64) ((double) frameBytes * 1000.0 / c.drainBytesPerSec));
         }
     }
+
+    publishQueueMetrics(nowMs);
+
+    if (m_plugins) m_plugins->markSent(QStringList(sent.begin(), sent.end()));
+    emit broadcasted();
+
+    if (std::exchange(m_broadcastAgain, false)) broadcastJson();
 }
 
 void DashboardWebSocketServer::sendResponse(const QJsonObject &data) {
     if (QThread::currentThread() != thread()) { return; }
     if (m_clients.isEmpty()) { return; }
 
-    QJsonDocument doc(data);
-    const QString json = QString::fromUtf8(doc.toJson(QJsonDocument::Compact));
+    // Encoded once per encoding, on first use.
+    QByteArray json, cbor;
+    QString text;
 
     const auto clients = m_clients; // snapshot
     for (QWebSocket *socket: clients) {
         if (!socket) continue;
-        if (socket->state() == QAbstractSocket::ConnectedState) {
-            socket->sendTextMessage(json);
+        if (socket->state() != QAbstractSocket::ConnectedState) continue;
+        const auto it = m_clientState.find(socket);
+        if (it == m_clientState.end()) continue;
+        if (it->encoding == Encoding::Cbor) {
+            if (cbor.isEmpty()) cbor = QCborMap::fromJsonObject(data).toCborValue().toCbor();
+            sendFrame(socket, *it, cbor, text);
+        } else {
+            if (json.isEmpty()) json = QJsonDocument(data).toJson(QJsonDocument::Compact);
+            sendFrame(socket, *it, json, text);
+        }
+    }
+}
+
+// Compressed frame: binary, 0xFF (never the first byte of a CBOR document),
+// uint32 big-endian length of the inflated frame, then the client's raw deflate
+// stream up to a sync flush. The inflated bytes are what the client would have
+// received otherwise: JSON text or CBOR.
+qint64 DashboardWebSocketServer::sendFrame(QWebSocket *socket, ClientState &client,
+                                           const QByteArray &bytes, QString &text) {
+    if (client.deflater && bytes.size() >= kCompressMinBytes) {
+        QByteArray frame;
+        frame.reserve(bytes.size() / 2 + 16);
+        frame += char(0xff);
+        const quint32 len = (quint32) bytes.size();
+        for (int shift = 24; shift >= 0; shift -= 8) frame += char((len >> shift) & 0xff);
+        if (client.deflater->compress(bytes, frame)) {
+            const qint64 sent = socket->sendBinaryMessage(frame);
+            client.sentBytes += sent;
+            return sent;
         }
+        // The stream is unusable; the client simply gets plain frames from now on.
+        Logger::warn("[WS] Compression failed, sending uncompressed to " + socket->peerAddress().toString());
+        client.deflater.reset();
     }
+
+    qint64 sent;
+    if (client.encoding == Encoding::Cbor) {
+        sent = socket->sendBinaryMessage(bytes);
+    } else {
+        if (text.isEmpty()) text = QString::fromUtf8(bytes);
+        sent = socket->sendTextMessage(text);
+    }
+    client.sentBytes += sent;
+    return sent;
+}
+
+void DashboardWebSocketServer::publishQueueMetrics(qint64 nowMs) {
+    if (!m_plugins || nowMs - m_metricsAtMs < 1000) return;
+    m_metricsAtMs = nowMs;
+
+    // {"websocket":{"queuedBytes":..,"clients":[{"peer":..,"queuedBytes":..,..}]}} in the host module
+    QJsonArray clients;
+    qint64 total = 0;
+    for (auto it = m_clientState.begin(); it != m_clientState.end(); ++it) {
+        const ClientState &c = it.value();
+        total += c.queuedBytes;
+        QJsonObject o;
+        o.insert("peer", it.key()->peerAddress().toString());
+        o.insert("encoding", c.encoding == Encoding::Cbor ? "cbor" : "json");
+        o.insert("compressed", c.deflater != nullptr);
+        o.insert("queuedBytes", c.queuedBytes);
+        o.insert("maxQueuedBytes", c.maxQueuedBytes);
+        o.insert("drainBytesPerSec", (qint64) c.drainBytesPerSec);
+        o.insert("updatesHeld", (qint64) c.updatesHeld);
+        clients.append(o);
+    }
+    QJsonObject section;
+    section.insert("queuedBytes", total);
+    section.insert("clients", clients);
+    m_plugins->setHostSection("websocket", section);
 }
 
 void DashboardWebSocketServer::handleModuleRequest(const QJsonObject &data) {
@@ -208,12 +805,32 @@ void DashboardWebSocketServer::handleModuleRequest(const QJsonObject &data) {
     const QJsonObject payload = data.value("payload").toObject();
     if (module.isEmpty()) return;
 
-    const QJsonObject res = m_plugins->request(module, payload);
-    // Optional: broadcast immediately after a module command.
-    if (!res.isEmpty()) {
-        Logger::info("[PLUGIN] " + module + " request ok");
-        sendResponse(res);
-        QTimer::singleShot(100, this, [&] { broadcastJson(); });
+    // Never wait for the plugin here: this thread also serves broadcasts and HTTPS.
+    m_plugins->requestAsync(module, payload, [liveness = m_liveness, this, module](const QJsonObject &res) {
+        postIfAlive(liveness, this, [this, module, res] { onModuleResponse(module, res); });
+    });
+}
+
+void DashboardWebSocketServer::onModuleResponse(const QString &module, const QJsonObject &res) {
+    if (res.isEmpty()) return;
+
+    Logger::info("[PLUGIN] " + module + " request ok");
+    sendResponse(res);
+
+    // Broadcast as soon as the plugin has ticked with the new state
+    // (plugins without wa_tick_now: give the next tick a head start).
+    // The module is due for every subscriber in that broadcast, whatever its rate.
+    const bool ticking = m_plugins && m_plugins->tickNow(module, [liveness = m_liveness, this, module] {
+        postIfAlive(liveness, this, [this, module] {
+            m_urgent.insert(module);
+            broadcastJson();
+        });
+    });
+    if (!ticking) {
+        QTimer::singleShot(100, this, [this, module] {
+            m_urgent.insert(module);
+            broadcastJson();
+        });
     }
 }
 
@@ -239,4 +856,8 @@ void DashboardWebSocketServer::closeAllClients() {
         socket->deleteLater();
     }
     m_clients.clear();
+    m_clientState.clear();
+    if (m_pending) m_pending->clients.clear();
+    m_broadcastTimer->setInterval(kDefaultIntervalMs);
+    if (m_plugins) m_plugins->setClientDemand(0);
 }
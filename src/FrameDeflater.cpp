@@ -0,0 +1,65 @@
+#include "FrameDeflater.h"
+
+#if defined(WA_HAVE_ZLIB)
+#include <zlib.h>
+#endif
+
+#if defined(WA_HAVE_ZLIB)
+
+struct FrameDeflater::Stream {
+    z_stream zs{};
+    bool ok = false;
+};
+
+FrameDeflater::FrameDeflater() : stream_(std::make_unique<Stream>()) {
+    // Negative window bits: raw deflate, no zlib header (what DecompressionStream("deflate-raw") reads).
+    stream_->ok = deflateInit2(&stream_->zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+}
+
+FrameDeflater::~FrameDeflater() {
+    if (stream_->ok) deflateEnd(&stream_->zs);
+}
+
+bool FrameDeflater::available() { return true; }
+
+bool FrameDeflater::compress(const QByteArray& in, QByteArray& out) {
+    if (!stream_->ok) return false;
+    z_stream& zs = stream_->zs;
+
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.constData()));
+    zs.avail_in = static_cast<uInt>(in.size());
+
+    // deflateBound() is for a whole stream, so one round is the norm; grow otherwise.
+    qsizetype used = out.size();
+    qsizetype room = static_cast<qsizetype>(deflateBound(&zs, static_cast<uLong>(in.size()))) + 16;
+    for (;;) {
+        out.resize(used + room);
+        zs.next_out = reinterpret_cast<Bytef*>(out.data() + used);
+        zs.avail_out = static_cast<uInt>(room);
+
+        const int rc = deflate(&zs, Z_SYNC_FLUSH);
+        if (rc != Z_OK && rc != Z_BUF_ERROR) {
+            stream_->ok = false;
+            out.resize(used);
+            return false;
+        }
+        used += room - static_cast<qsizetype>(zs.avail_out);
+        if (zs.avail_out != 0) break; // flushed completely
+        room *= 2;
+    }
+    out.resize(used);
+    return true;
+}
+
+#else
+
+struct FrameDeflater::Stream {};
+
+FrameDeflater::FrameDeflater() = default;
+FrameDeflater::~FrameDeflater() = default;
+
+bool FrameDeflater::available() { return false; }
+
+bool FrameDeflater::compress(const QByteArray&, QByteArray&) { return false; }
+
+#endif
@@ -12,11 +12,10 @@
 #include <QTabWidget>
 #include <QLabel>
 #include <QMenu>
-#include <QSaveFile>
-#include <QRandomGenerator>
 #include <QClipboard>
 #include <QGuiApplication>
 
+#include "AuthSecret.h"
 #include "Logger.h"
 #include "PluginOverviewWidget.h"
 
@@ -31,7 +30,7 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
     setupUI();
     setupTray();
 
-    m_authKey = loadOrCreateSecret();
+    m_authKey = AuthSecret::loadOrCreate();
     updateSecretUi();
 
     connect(&Logger::instance(), &Logger::logMessage, this, [this](const QString &msg, const QString &color, const bool bold) {
@@ -42,25 +41,38 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
 
     // Load external plugins from: <exe_dir>/plugins
     const QString pluginDir = QCoreApplication::applicationDirPath() + "/plugins";
+    plugins_.setGuiVisible(false); // usually starts in the tray; showEvent() flips it
     plugins_.loadFromDir(pluginDir, plugins_.hostApi());
     refreshPluginsTab();
 
     // Wire Dashboard plugin overview (top-left area)
     if (pluginOverview_) {
+        // Start/restart wait for the new handle's first snapshot: keep that off the GUI
+        // thread and report back here once the control thread is done. plugins_ waits
+        // for that thread when it is destroyed, before this object's QObject part.
         connect(pluginOverview_, &PluginOverviewWidget::startPluginRequested, this, [this](const QString& id) {
-            const int32_t rc = plugins_.startPlugin(id);
-            if (rc == WA_OK) Logger::success("[PLUGIN] started: " + id);
-            else Logger::error("[PLUGIN] start failed: " + id);
+            plugins_.startPluginAsync(id, [this, id](int32_t rc) {
+                QMetaObject::invokeMethod(this, [id, rc] {
+                    if (rc == WA_OK) Logger::success("[PLUGIN] started: " + id);
+                    else Logger::error("[PLUGIN] start failed: " + id);
+                }, Qt::QueuedConnection);
+            });
         });
         connect(pluginOverview_, &PluginOverviewWidget::stopPluginRequested, this, [this](const QString& id) {
-            const int32_t rc = plugins_.stopPlugin(id);
-            if (rc == WA_OK) Logger::warn("[PLUGIN] stopped/paused: " + id);
-            else Logger::error("[PLUGIN] stop failed: " + id);
+            plugins_.stopPluginAsync(id, [this, id](int32_t rc) {
+                QMetaObject::invokeMethod(this, [id, rc] {
+                    if (rc == WA_OK) Logger::warn("[PLUGIN] stopped/paused: " + id);
+                    else Logger::error("[PLUGIN] stop failed: " + id);
+                }, Qt::QueuedConnection);
+            });
         });
         connect(pluginOverview_, &PluginOverviewWidget::restartPluginRequested, this, [this](const QString& id) {
-            const int32_t rc = plugins_.restartPlugin(id);
-            if (rc == WA_OK) Logger::info("[PLUGIN] restarted: " + id);
-            else Logger::error("[PLUGIN] restart failed: " + id);
+            plugins_.restartPluginAsync(id, [this, id](int32_t rc) {
+                QMetaObject::invokeMethod(this, [id, rc] {
+                    if (rc == WA_OK) Logger::info("[PLUGIN] restarted: " + id);
+                    else Logger::error("[PLUGIN] restart failed: " + id);
+                }, Qt::QueuedConnection);
+            });
         });
         connect(pluginOverview_, &PluginOverviewWidget::openPluginUiRequested, this, [this](const QString& id) {
             if (!tabWidget || !tabPlugins || !tabPluginsInner) return;
@@ -106,6 +118,7 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
     connect(uiTickTimer_, &QTimer::timeout, this, &MainWindow::tickDashboardUi);
     uiTickTimer_->start();
     tickDashboardUi();
+    updateGuiDemand();
 
     connect(m_DashboardServerThread, &QThread::finished, m_DashboardWebServer, &DashboardServer::deleteLater);
     connect(m_DashboardServerThread, &QThread::finished, m_DashboardSocketServer, &DashboardWebSocketServer::deleteLater);
@@ -293,8 +306,8 @@ void MainWindow::copyAuthKey() {
 }
 
 void MainWindow::regenerateAuthKey() {
-    m_authKey = generate6DigitSecret();
-    writeSecretFile(m_authKey);
+    m_authKey = AuthSecret::generate();
+    AuthSecret::write(m_authKey);
     updateSecretUi();
 
     applySecretToWsServer();
@@ -347,10 +360,32 @@ void MainWindow::changeEvent(QEvent *event) {
         if (isMinimized() && m_tray) {
             QTimer::singleShot(0, this, [this] { hideToTray(); });
         }
+        updateGuiDemand();
     }
     QMainWindow::changeEvent(event);
 }
 
+void MainWindow::showEvent(QShowEvent *event) {
+    QMainWindow::showEvent(event);
+    updateGuiDemand();
+}
+
+void MainWindow::hideEvent(QHideEvent *event) {
+    QMainWindow::hideEvent(event);
+    updateGuiDemand();
+}
+
+void MainWindow::updateGuiDemand() {
+    // Plugins may park while neither the window nor a dashboard client is looking.
+    const bool visible = isVisible() && !isMinimized();
+    plugins_.setGuiVisible(visible);
+
+    if (uiTickTimer_) {
+        if (visible && !uiTickTimer_->isActive()) uiTickTimer_->start();
+        else if (!visible) uiTickTimer_->stop();
+    }
+}
+
 void MainWindow::closeEvent(QCloseEvent *event) {
     if (m_tray) {
         hideToTray();
@@ -422,38 +457,6 @@ void MainWindow::refreshPluginsTab() {
     }
 }
 
-QString MainWindow::authSecretPath() const {
-    // %USER_HOME%/winagent.secret
-    return QDir::home().absoluteFilePath("winagent.secret");
-}
-
-QString MainWindow::generate6DigitSecret() const {
-    const int n = QRandomGenerator::global()->bounded(0, 1000000);
-    return QString("%1").arg(n, 6, 10, QChar('0'));
-}
-
-bool MainWindow::writeSecretFile(const QString &s) {
-    QSaveFile f(authSecretPath());
-    if (!f.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
-    f.write(s.toUtf8());
-    f.write("\n");
-    return f.commit();
-}
-
-QString MainWindow::loadOrCreateSecret() {
-    QFile f(authSecretPath());
-    if (f.exists() && f.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        const QString s = QString::fromUtf8(f.readAll()).trimmed();
-        if (s.size() == 6 && std::all_of(s.begin(), s.end(), [](QChar c) { return c.isDigit(); })) {
-            return s;
-        }
-    }
-
-    const QString s = generate6DigitSecret();
-    writeSecretFile(s);
-    return s;
-}
-
 void MainWindow::applySecretToWsServer() {
     if (!m_DashboardSocketServer) return;
     QMetaObject::invokeMethod(
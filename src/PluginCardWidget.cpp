@@ -42,6 +42,12 @@ static QString stateDotColor(int32_t state) {
     }
 }
 
+static QString usText(uint64_t us) {
+    if (us < 1000) return QString::number(static_cast<qulonglong>(us)) + "us";
+    if (us < 1000ull * 1000ull) return QString::number(static_cast<double>(us) / 1000.0, 'f', 1) + "ms";
+    return QString::number(static_cast<double>(us) / (1000.0 * 1000.0), 'f', 2) + "s";
+}
+
 static QString agoText(qint64 nowMs, qint64 thenMs) {
     if (thenMs <= 0) return "-";
     qint64 diff = nowMs - thenMs;
@@ -154,9 +160,19 @@ PluginCardWidget::PluginCardWidget(QWidget* parent) : QFrame(parent) {
     chipReq_->setStyleSheet(chipStyle("#2A2A2A"));
     chipReq_->setToolTip("Client requests");
 
+    chipTick_ = new QLabel("T -", this);
+    chipTick_->setStyleSheet(chipStyle("#2A2A2A"));
+    chipTick_->hide();
+
+    chipCpu_ = new QLabel("C -", this);
+    chipCpu_->setStyleSheet(chipStyle("#2A2A2A"));
+    chipCpu_->hide();
+
     rowChips->addWidget(chipReads_);
     rowChips->addWidget(chipSent_);
     rowChips->addWidget(chipReq_);
+    rowChips->addWidget(chipTick_);
+    rowChips->addWidget(chipCpu_);
     rowChips->addStretch(1);
     root->addLayout(rowChips);
 
@@ -209,6 +225,21 @@ void PluginCardWidget::setStaticInfo(
     btnUi_->setVisible(hasUi_);
 }
 
+void PluginCardWidget::setStartupTiming(
+    uint64_t loadUs,
+    uint64_t resolveUs,
+    uint64_t createUs,
+    uint64_t initUs,
+    uint64_t startUs
+) {
+    const uint64_t totalUs = loadUs + resolveUs + createUs + initUs + startUs;
+    if (totalUs == 0) return;
+    lblId_->setToolTip(QString(
+        "Startup: %1\n"
+        "load %2 • resolve %3 • create %4 • init %5 • start %6")
+        .arg(usText(totalUs), usText(loadUs), usText(resolveUs), usText(createUs), usText(initUs), usText(startUs)));
+}
+
 void PluginCardWidget::updateRuntime(
     int32_t state,
     uint64_t reads,
@@ -238,6 +269,103 @@ void PluginCardWidget::updateRuntime(
     }
 }
 
+void PluginCardWidget::updateTiming(
+    bool hasStats,
+    uint64_t ticks,
+    uint64_t overruns,
+    uint64_t skipped,
+    uint64_t lastTickUs,
+    uint64_t p50TickUs,
+    uint64_t p95TickUs,
+    uint64_t maxTickUs,
+    uint64_t p95JitterUs,
+    uint64_t maxJitterUs
+) {
+    chipTick_->setVisible(hasStats);
+    if (!hasStats) return;
+
+    // p95 tick time; amber once the plugin starts missing deadlines.
+    chipTick_->setText("T " + usText(p95TickUs));
+    chipTick_->setStyleSheet(chipStyle(overruns > 0 ? "#5A4300" : "#2A2A2A"));
+    chipTick_->setToolTip(QString(
+        "Tick time: last %1 • p50 ≤%2 • p95 ≤%3 • max %4\n"
+        "Wake jitter: p95 ≤%5 • max %6\n"
+        "Ticks %7 • overruns %8 • skipped %9")
+        .arg(usText(lastTickUs), usText(p50TickUs), usText(p95TickUs), usText(maxTickUs),
+             usText(p95JitterUs), usText(maxJitterUs))
+        .arg(formatCount(ticks), formatCount(overruns), formatCount(skipped)));
+}
+
+void PluginCardWidget::updateReadTiming(uint64_t lastReadUs, uint64_t maxReadUs, uint64_t late) {
+    // Amber reads chip once a read missed the broadcast deadline.
+    chipReads_->setStyleSheet(chipStyle(late > 0 ? "#5A4300" : "#2A2A2A"));
+    chipReads_->setToolTip(QString(
+        "Plugin data reads\n"
+        "Read time: last %1 • max %2\n"
+        "Late (stale in broadcast): %3")
+        .arg(usText(lastReadUs), usText(maxReadUs), formatCount(late)));
+}
+
+void PluginCardWidget::updateCallTiming(
+    uint64_t calls,
+    uint64_t p50CallUs,
+    uint64_t p95CallUs,
+    uint64_t p99CallUs,
+    uint64_t maxCallUs,
+    bool quarantined,
+    uint32_t quarantines
+) {
+    if (quarantined) {
+        lblStatusText_->setText("Quarantined");
+    }
+    lblStatusText_->setToolTip(QString(
+        "Host calls: %1 • p50 ≤%2 • p95 ≤%3 • p99 ≤%4 • max %5\n"
+        "Quarantined by the watchdog: %6×")
+        .arg(formatCount(calls), usText(p50CallUs), usText(p95CallUs), usText(p99CallUs), usText(maxCallUs))
+        .arg(static_cast<qulonglong>(quarantines)));
+}
+
+void PluginCardWidget::updateCost(
+    bool hasCost,
+    uint64_t tickCpuUs,
+    uint64_t tickCpuMaxUs,
+    bool countsAllocs,
+    uint64_t allocs,
+    uint64_t allocBytes,
+    uint64_t readTotalUs,
+    uint64_t requestTotalUs,
+    uint64_t snapshotBytes,
+    uint64_t snapshotBytesTotal
+) {
+    chipCpu_->setVisible(hasCost);
+    if (!hasCost) {
+        prevCpuAtMs_ = 0;
+        return;
+    }
+
+    // Share of one core since the previous update; a recreated handle restarts its totals.
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    if (prevCpuAtMs_ > 0 && nowMs > prevCpuAtMs_ && tickCpuUs >= prevCpuUs_) {
+        const double pct = static_cast<double>(tickCpuUs - prevCpuUs_) /
+                           (static_cast<double>(nowMs - prevCpuAtMs_) * 10.0);
+        chipCpu_->setText("C " + QString::number(pct, 'f', pct < 10.0 ? 1 : 0) + "%");
+        chipCpu_->setStyleSheet(chipStyle(pct >= 25.0 ? "#5A4300" : "#2A2A2A"));
+    }
+    prevCpuUs_ = tickCpuUs;
+    prevCpuAtMs_ = nowMs;
+
+    QString tip = QString(
+        "Tick CPU: total %1 • max %2\n"
+        "Host wall time: reads %3 • requests %4\n"
+        "Snapshot: %5 B • published %6 B")
+        .arg(usText(tickCpuUs), usText(tickCpuMaxUs), usText(readTotalUs), usText(requestTotalUs),
+             formatCount(snapshotBytes), formatCount(snapshotBytesTotal));
+    if (countsAllocs) {
+        tip += QString("\nAllocations: %1 • %2 B").arg(formatCount(allocs), formatCount(allocBytes));
+    }
+    chipCpu_->setToolTip(tip);
+}
+
 void PluginCardWidget::mouseDoubleClickEvent(QMouseEvent* e) {
     if (e) e->accept();
     if (hasUi_ && !pluginId_.isEmpty()) emit openUiRequested(pluginId_);
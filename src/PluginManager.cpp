@@ -1,15 +1,30 @@
 #include "PluginManager.h"
 
+#if defined(_WIN32)
 #include <windows.h>
-
+#else
+#include <time.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <bit>
+#include <future>
+#include <chrono>
+#include <thread>
+
+#include <QCborMap>
+#include <QCborValue>
+#include <QCoreApplication>
 #include <QDateTime>
 #include <QDir>
 #include <QFile>
 #include <QJsonDocument>
 #include <QJsonParseError>
-#include <QWidget>
+#include <QThreadPool>
 
 #include "Logger.h"
+#include "WireFormat.h"
 
 static QByteArray readTextFileIfExists(const QString &path) {
     QFile f(path);
@@ -26,6 +41,67 @@ QJsonObject PluginManager::parseJsonObjectUtf8(const char *ptr, uint32_t len) {
     return doc.object();
 }
 
+// Upper bound (us) of the histogram bucket holding the q-quantile (see WaTickStats).
+static uint64_t histPercentileUs(const uint64_t *hist, double q) {
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < WA_TICK_HIST_BUCKETS; i++) total += hist[i];
+    if (total == 0) return 0;
+
+    const double target = q * (double) total;
+    uint64_t acc = 0;
+    for (uint32_t i = 0; i < WA_TICK_HIST_BUCKETS; i++) {
+        acc += hist[i];
+        if ((double) acc >= target) return 64ull << i;
+    }
+    return 64ull << (WA_TICK_HIST_BUCKETS - 1);
+}
+
+static uint32_t histBucket(uint64_t us) {
+    return std::min<uint32_t>((uint32_t) std::bit_width(us >> 6), WA_TICK_HIST_BUCKETS - 1);
+}
+
+static int64_t steadyUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Per-plugin watchdog budget override ("callBudgetMs" in config.json), 0 = default.
+static uint32_t callBudgetFromConfig(const QByteArray &cfgJson) {
+    if (cfgJson.isEmpty()) return 0;
+    const int ms = QJsonDocument::fromJson(cfgJson).object().value("callBudgetMs").toInt(0);
+    return ms > 0 ? (uint32_t) ms : 0;
+}
+
+// "workerProcess": true in config.json runs the plugin in its own process (read at load).
+static bool workerFromConfig(const QByteArray &cfgJson) {
+    if (cfgJson.isEmpty()) return false;
+    return QJsonDocument::fromJson(cfgJson).object().value("workerProcess").toBool(false);
+}
+
+// Snapshot ring slot size for worker plugins ("workerRingKiB"); larger snapshots
+// take an IPC round-trip instead.
+static uint32_t ringKiBFromConfig(const QByteArray &cfgJson) {
+    const int kib = cfgJson.isEmpty() ? 0 : QJsonDocument::fromJson(cfgJson).object().value("workerRingKiB").toInt(0);
+    return kib > 0 ? (uint32_t) kib : 256;
+}
+
+static void storeMax(std::atomic<uint64_t> &slot, uint64_t v) {
+    uint64_t cur = slot.load(std::memory_order_relaxed);
+    while (v > cur && !slot.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {}
+}
+
+QJsonObject PluginManager::parseViewObject(const WaView &v, uint32_t format) {
+    if (!v.ptr || v.len == 0) return {};
+    if (format == WA_FMT_JSON) return parseJsonObjectUtf8(v.ptr, v.len);
+    if (format != WA_FMT_CBOR) return {};
+
+    // The view is only borrowed; fromRawData avoids a copy while decoding.
+    QCborParserError err;
+    const QCborValue cv = QCborValue::fromCbor(QByteArray::fromRawData(v.ptr, (qsizetype) v.len), &err);
+    if (err.error != QCborError::NoError || !cv.isMap()) return {};
+    return cv.toMap().toJsonObject();
+}
+
 PluginManager::PluginManager() {
     hostApi_.apiVersion = WA_HOST_API_VERSION;
     hostApi_.user = this;
@@ -33,14 +109,122 @@ PluginManager::PluginManager() {
     hostApi_.plugin_start = &PluginManager::host_start;
     hostApi_.plugin_stop = &PluginManager::host_stop;
     hostApi_.plugin_restart = &PluginManager::host_restart;
+    hostApi_.sched_register = &PluginManager::host_sched_register;
+    hostApi_.sched_unregister = &PluginManager::host_sched_unregister;
+    hostApi_.sched_set_interval = &PluginManager::host_sched_set_interval;
+    hostApi_.sched_set_active = &PluginManager::host_sched_set_active;
+    hostApi_.sched_wake = &PluginManager::host_sched_wake;
+    hostApi_.demand_get = &PluginManager::host_demand_get;
+    hostApi_.plugin_reconfigure = &PluginManager::host_reconfigure;
+
+    // Reads are short (pin + decode); a few threads cover the slow ones.
+    readPoolBase_ = (int) std::clamp(std::thread::hardware_concurrency(), 2u, 4u);
+    readPool_.setMaxThreadCount(readPoolBase_);
+    controlPool_.setMaxThreadCount(1);
+
+#if defined(_WIN32)
+    workerExe_ = QCoreApplication::applicationDirPath() + "/WinAgentPluginHost.exe";
+#else
+    workerExe_ = QCoreApplication::applicationDirPath() + "/WinAgentPluginHost";
+#endif
+}
+
+PluginManager::~PluginManager() {
+    stopWatchdog();
+    if (workerIo_.isRunning()) {
+        workerIo_.quit();
+        workerIo_.wait();
+    }
+}
+
+void PluginManager::setWorkerExecutable(const QString &path) {
+    workerExe_ = path;
+}
+
+QThread *PluginManager::workerIo() {
+    std::call_once(workerIoOnce_, [this] {
+        workerIo_.setObjectName("PluginWorkerIo");
+        workerIo_.start();
+    });
+    return &workerIo_;
+}
+
+void PluginManager::bindWorker(Loaded *p) {
+    // The shims take the worker process as the handle; everything above the ABI
+    // (watchdog, blue/green restart, demand, async requests) stays the same.
+    PluginWorker *w = p->worker.get();
+    p->init = &PluginWorker::init;
+    p->start = &PluginWorker::start;
+    p->stop = &PluginWorker::stop;
+    p->destroy = &PluginWorker::destroy;
+    p->read = &PluginWorker::read;
+    p->req = &PluginWorker::request;
+
+    // Snapshots always come through the ring, which carries generations.
+    p->read_if_changed = &PluginWorker::readIfChanged;
+    p->view_format = &PluginWorker::viewFormat;
+    // Also without wa_set_demand: the worker answers demand_get from it.
+    p->set_demand = &PluginWorker::setDemand;
+
+    if (w->has(WorkerIpc::HasPause)) p->pause = &PluginWorker::pause;
+    if (w->has(WorkerIpc::HasResume)) p->resume = &PluginWorker::resume;
+    if (w->has(WorkerIpc::HasTickStats)) p->get_tick_stats = &PluginWorker::getTickStats;
+    if (w->has(WorkerIpc::HasCostStats)) p->get_cost_stats = &PluginWorker::getCostStats;
+    if (w->has(WorkerIpc::HasRequestAsync)) p->req_async = &PluginWorker::requestAsync;
+    if (w->has(WorkerIpc::HasTickNow)) p->tick_now = &PluginWorker::tickNow;
+    if (w->has(WorkerIpc::HasConfigure)) p->configure = &PluginWorker::configure;
+    // No widgets: a QWidget cannot cross the process boundary.
+}
+
+void *PluginManager::createHandle(Loaded *p, void *hostCtx, const QByteArray &cfgJson,
+                                  std::chrono::milliseconds budget) {
+    const char *cfg = cfgJson.isEmpty() ? nullptr : cfgJson.constData();
+    if (p->worker) return p->worker->create(hostCtx, cfg, budget);
+    return p->create(hostCtx, cfg);
 }
 
 PluginManager::Loaded *PluginManager::findLoadedNoLock(const QString &id) const {
+    return findSharedNoLock(id).get();
+}
+
+std::shared_ptr<PluginManager::Loaded> PluginManager::findSharedNoLock(const QString &id) const {
     const auto it = byId_.find(id.toStdString());
     if (it == byId_.end()) return nullptr;
     const size_t idx = it->second;
     if (idx >= plugins_.size()) return nullptr;
-    return plugins_[idx].get();
+    return plugins_[idx];
+}
+
+static uint64_t usSince(std::chrono::steady_clock::time_point &t0) {
+    const auto now = std::chrono::steady_clock::now();
+    const auto us = (uint64_t) std::chrono::duration_cast<std::chrono::microseconds>(now - t0).count();
+    t0 = now;
+    return us;
+}
+
+static std::chrono::milliseconds remainingUntil(std::chrono::steady_clock::time_point deadline) {
+    const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+    return std::max(left, std::chrono::milliseconds(0));
+}
+
+static QString msText(uint64_t us) {
+    return QString::number((double) us / 1000.0, 'f', 1) + "ms";
+}
+
+// Plugin library inside plugins/<id>/, empty if the folder holds none for this platform.
+static QString findPluginLibrary(const QDir &pd, const QString &id) {
+#if defined(_WIN32)
+    const QStringList names{id + ".dll"};
+#elif defined(__APPLE__)
+    const QStringList names{"lib" + id + ".dylib", id + ".dylib"};
+#else
+    const QStringList names{"lib" + id + ".so", id + ".so"};
+#endif
+    for (const QString &n: names) {
+        const QString path = pd.absoluteFilePath(n);
+        if (QFileInfo::exists(path)) return path;
+    }
+    return {};
 }
 
 bool PluginManager::loadFromDir(const QString &dirPath, void *hostCtx) { {
@@ -56,229 +240,713 @@ bool PluginManager::loadFromDir(const QString &dirPath, void *hostCtx) { {
     }
 
     // Layout:
-    // plugins/<id>/<id>.dll
+    // plugins/<id>/<id>.dll                   (Windows)
+    // plugins/<id>/lib<id>.so or <id>.so      (Linux)
     // plugins/<id>/config.json
+    struct Candidate {
+        QString dllPath;
+        QString configPath;
+        std::shared_ptr<Loaded> p;
+    };
+    std::vector<Candidate> candidates;
     const auto subdirs = root.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
-
     for (const QFileInfo &sub: subdirs) {
-        const QString folderName = sub.fileName();
         QDir pd(sub.absoluteFilePath());
+        const QString dllPath = findPluginLibrary(pd, sub.fileName());
+        if (dllPath.isEmpty()) continue;
+        candidates.push_back(Candidate{dllPath, pd.absoluteFilePath("config.json"), nullptr});
+    }
 
-        QStringList candidates;
-        candidates << pd.absoluteFilePath(folderName + ".dll");
+    // One slow constructor or onInit() must not hold back the others.
+    const auto t0 = std::chrono::steady_clock::now();
+    QThreadPool startupPool;
+    startupPool.setMaxThreadCount((int) std::clamp(std::thread::hardware_concurrency(), 2u, 8u));
+    for (Candidate &c: candidates) {
+        startupPool.start([this, &c, hostCtx] { c.p = loadOne(c.dllPath, c.configPath, hostCtx); });
+    }
+    startupPool.waitForDone();
+    const uint64_t wallUs = (uint64_t) std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - t0).count();
+
+    // Register in directory order, independent of which plugin finished first.
+    uint64_t sumUs = 0;
+    int started = 0;
+    for (Candidate &c: candidates) {
+        if (!c.p) continue;
+        const StartupTiming &st = c.p->startup;
+        sumUs += st.loadUs + st.resolveUs + st.createUs + st.initUs + st.startUs;
+        started++;
+
+        Logger::success(QString("[PLUGIN] Loaded: %1 (%2)%3 • load %4 • resolve %5 • create %6 • init %7 • start %8")
+            .arg(c.p->name, c.p->id, c.p->worker ? " in a worker process" : "", msText(st.loadUs),
+                 msText(st.resolveUs), msText(st.createUs), msText(st.initUs), msText(st.startUs)));
 
-        for (const QString &dllPath: candidates) {
-            if (!QFileInfo::exists(dllPath))
-                continue;
+        std::lock_guard<std::mutex> g(mu_);
+        byId_[c.p->id.toStdString()] = plugins_.size();
+        plugins_.push_back(std::move(c.p));
+        publishTableNoLock();
+    }
 
-            auto p = std::make_unique<Loaded>();
-            p->lib.setFileName(dllPath);
+    if (started > 0) {
+        Logger::info(QString("[PLUGIN] Started %1 plugin(s) in %2 (%3 one after another)")
+            .arg(started).arg(msText(wallUs), msText(sumUs)));
+    }
 
+    publishDemand();
+    startWatchdog();
+    return true;
+}
+
+std::shared_ptr<PluginManager::Loaded> PluginManager::loadOne(const QString &dllPath, const QString &configPath,
+                                                               void *hostCtx) {
+    auto p = std::make_shared<Loaded>();
+
+    // Config: plugins/<folderName>/config.json
+    p->configPath = configPath;
+    const QByteArray cfgJson = readTextFileIfExists(p->configPath);
+    p->callBudgetMs = callBudgetFromConfig(cfgJson);
+    const auto budget = budgetNoLock(p.get());
+
+    auto t = std::chrono::steady_clock::now();
+    // A worker gets one budget for spawn + create + init + start, not one per step.
+    const auto deadline = t + budget;
+    if (workerFromConfig(cfgJson)) {
+        // Out of process: the worker loads the library ("load" is the spawn + handshake).
+        p->worker = std::make_unique<PluginWorker>(workerIo(), workerExe_, dllPath, ringKiBFromConfig(cfgJson));
+        QString error;
+        if (!p->worker->probe(budget, &error)) {
+            Logger::error("[PLUGIN] Worker failed: " + QFileInfo(dllPath).fileName() + " => " + error);
+            return nullptr;
+        }
+        p->startup.loadUs = usSince(t);
+        bindWorker(p.get());
+        p->info = p->worker->info();
+    } else {
+        p->lib.setFileName(dllPath);
+        {
+            std::lock_guard<std::mutex> g(loaderMu_);
+            t = std::chrono::steady_clock::now();
+
+#if defined(_WIN32)
+            // Let the plugin's own dependencies (hidapi.dll, ...) resolve from its folder.
             const QString folder = QFileInfo(dllPath).absolutePath();
             SetDllDirectoryW(reinterpret_cast<LPCWSTR>(folder.utf16()));
+#endif
 
             if (!p->lib.load()) {
                 Logger::error("[PLUGIN] Load failed: " + QFileInfo(dllPath).fileName() + " => " + p->lib.errorString());
-                continue;
-            }
-
-            // Required exports
-            p->get_info = (FnGetInfo) p->lib.resolve("wa_get_info");
-            p->create = (FnCreate) p->lib.resolve("wa_create");
-            p->init = (FnInit) p->lib.resolve("wa_init");
-            p->start = (FnStart) p->lib.resolve("wa_start");
-            p->stop = (FnStop) p->lib.resolve("wa_stop");
-            p->destroy = (FnDestroy) p->lib.resolve("wa_destroy");
-            p->read = (FnRead) p->lib.resolve("wa_read");
-            p->req = (FnReq) p->lib.resolve("wa_request");
-
-            // Optional exports
-            p->pause = (FnPause) p->lib.resolve("wa_pause");
-            p->resume = (FnResume) p->lib.resolve("wa_resume");
-            p->create_widget = (FnCreateWidget) p->lib.resolve("wa_create_widget");
-
-            const bool missingRequired =
-                    !p->get_info || !p->create || !p->init || !p->start ||
-                    !p->stop || !p->destroy || !p->read || !p->req;
-
-            if (missingRequired) {
-                Logger::error("[PLUGIN] Missing exports: " + QFileInfo(dllPath).fileName());
-                p->lib.unload();
-                continue;
-            }
-
-            p->info = p->get_info();
-            if (!p->info || p->info->apiVersion != WA_PLUGIN_API_VERSION || !p->info->id) {
-                Logger::error("[PLUGIN] Invalid plugin info: " + QFileInfo(dllPath).fileName());
-                p->lib.unload();
-                continue;
-            }
-
-            // Config: plugins/<folderName>/config.json
-            p->configPath = pd.absoluteFilePath("config.json");
-            const QByteArray cfgJson = readTextFileIfExists(p->configPath);
-
-            // Create/init/start
-            p->handle = p->create(hostCtx, cfgJson.isEmpty() ? nullptr : cfgJson.constData());
-            if (!p->handle) {
-                Logger::error(QString("[PLUGIN] create() failed: %1 (%2)")
-                    .arg(p->info->name)
-                    .arg(p->info->id));
-                p->lib.unload();
-                continue;
+                return nullptr;
             }
+        }
+        p->startup.loadUs = usSince(t);
+
+        // Required exports
+        p->get_info = (FnGetInfo) p->lib.resolve("wa_get_info");
+        p->create = (FnCreate) p->lib.resolve("wa_create");
+        p->init = (FnInit) p->lib.resolve("wa_init");
+        p->start = (FnStart) p->lib.resolve("wa_start");
+        p->stop = (FnStop) p->lib.resolve("wa_stop");
+        p->destroy = (FnDestroy) p->lib.resolve("wa_destroy");
+        p->read = (FnRead) p->lib.resolve("wa_read");
+        p->req = (FnReq) p->lib.resolve("wa_request");
+
+        // Optional exports
+        p->pause = (FnPause) p->lib.resolve("wa_pause");
+        p->resume = (FnResume) p->lib.resolve("wa_resume");
+        p->create_widget = (FnCreateWidget) p->lib.resolve("wa_create_widget");
+        p->read_if_changed = (FnReadIfChanged) p->lib.resolve("wa_read_if_changed");
+        p->get_tick_stats = (FnGetTickStats) p->lib.resolve("wa_get_tick_stats");
+        p->get_cost_stats = (FnGetCostStats) p->lib.resolve("wa_get_cost_stats");
+        p->req_async = (FnReqAsync) p->lib.resolve("wa_request_async");
+        p->set_demand = (FnSetDemand) p->lib.resolve("wa_set_demand");
+        p->tick_now = (FnTickNow) p->lib.resolve("wa_tick_now");
+        p->configure = (FnConfigure) p->lib.resolve("wa_configure");
+        p->view_format = (FnViewFormat) p->lib.resolve("wa_get_view_format");
+
+        const bool missingRequired =
+                !p->get_info || !p->create || !p->init || !p->start ||
+                !p->stop || !p->destroy || !p->read || !p->req;
+
+        if (missingRequired) {
+            Logger::error("[PLUGIN] Missing exports: " + QFileInfo(dllPath).fileName());
+            p->lib.unload();
+            return nullptr;
+        }
 
-            if (p->init(p->handle) != WA_OK) {
-                Logger::error(QString("[PLUGIN] init() failed: %1 (%2)")
-                    .arg(p->info->name)
-                    .arg(p->info->id));
-                p->destroy(p->handle);
-                p->handle = nullptr;
-                p->lib.unload();
-                continue;
-            }
+        p->info = p->get_info();
+    }
 
-            if (p->start(p->handle) != WA_OK) {
-                Logger::error(QString("[PLUGIN] start() failed: %1 (%2)")
-                    .arg(p->info->name)
-                    .arg(p->info->id));
-                p->destroy(p->handle);
-                p->handle = nullptr;
-                p->lib.unload();
-                continue;
-            }
+    if (!p->info || !p->info->id || p->info->apiVersion != WA_PLUGIN_API_VERSION) {
+        Logger::error("[PLUGIN] Invalid plugin info: " + QFileInfo(dllPath).fileName());
+        p->lib.unload();
+        return nullptr;
+    }
 
-            p->state = State::Running;
+    p->id = QString::fromUtf8(p->info->id);
+    if (p->id == kHostModuleId) {
+        Logger::error("[PLUGIN] Plugin id \"" + p->id + "\" is reserved: " + QFileInfo(dllPath).fileName());
+        p->lib.unload();
+        return nullptr;
+    }
+    p->name = QString::fromUtf8(p->info->name ? p->info->name : p->info->id);
+    p->description = QString::fromUtf8(p->info->desc);
+    p->defaultIntervalMs = p->info->defaultIntervalMs;
+    p->startup.resolveUs = usSince(t);
+
+    // Create/init/start
+    void *handle = createHandle(p.get(), hostCtx, cfgJson, remainingUntil(deadline));
+    p->startup.createUs = usSince(t);
+    if (!handle) {
+        Logger::error(QString("[PLUGIN] create() failed: %1 (%2)").arg(p->name, p->id));
+        p->lib.unload();
+        return nullptr;
+    }
+    if (p->worker) PluginWorker::setDeadline(handle, deadline);
 
-            const auto name = p->info->name ? p->info->name : p->info->id;
-            const auto id = p->info->id; {
-                std::lock_guard<std::mutex> g(mu_);
-                byId_[p->info->id] = plugins_.size();
-                plugins_.push_back(std::move(p));
-            }
+    const int32_t initRc = p->init(handle);
+    p->startup.initUs = usSince(t);
+    if (initRc != WA_OK) {
+        Logger::error(QString("[PLUGIN] init() failed: %1 (%2) after %3").arg(p->name, p->id, msText(p->startup.initUs)));
+        p->destroy(handle);
+        p->lib.unload();
+        return nullptr;
+    }
 
-            Logger::success(QString("[PLUGIN] Loaded: %1 (%2)").arg(name).arg(id));
-            break;
+    // Tell the plugin whether anyone is watching before its first tick.
+    if (p->set_demand) {
+        {
+            std::lock_guard<std::mutex> g(mu_);
+            p->demand = demandForNoLock(p->id);
         }
+        p->set_demand(handle, p->demand);
     }
 
-    return true;
+    const int32_t startRc = p->start(handle);
+    p->startup.startUs = usSince(t);
+    if (startRc != WA_OK) {
+        Logger::error(QString("[PLUGIN] start() failed: %1 (%2)").arg(p->name, p->id));
+        p->destroy(handle);
+        p->lib.unload();
+        return nullptr;
+    }
+
+    // From here on a hung call is the watchdog's business.
+    if (p->worker) PluginWorker::setDeadline(handle, std::chrono::steady_clock::time_point::max());
+
+    p->state = State::Running;
+    p->inst = std::make_shared<Instance>();
+    p->inst->handle = handle;
+    p->inst->format = p->view_format ? p->view_format(handle) : WA_FMT_JSON;
+    return p;
 }
 
 void PluginManager::stopAll() {
+    // No background restarts racing the shutdown.
+    stopWatchdog();
+
     std::unique_lock<std::mutex> lk(mu_);
 
     for (auto &p: plugins_) {
         if (!p) continue;
 
-        // Wait until no in-flight calls (read/request/widget create)
-        cv_.wait(lk, [&] { return p->inFlight.load(std::memory_order_relaxed) == 0; });
-
-        if (!p->handle) {
-            p->state = State::Stopped;
-            p->lib.unload();
-            continue;
-        }
-
-        void *handle = p->handle;
-        auto stopFn = p->stop;
-        auto destroyFn = p->destroy;
+        // Wait until no in-flight calls (request/widget create); a hung one is abandoned.
+        waitNoInflight(lk, p.get(), cv_);
 
-        p->handle = nullptr;
+        std::shared_ptr<Instance> inst = std::move(p->inst);
+        if (inst) inst->detached.store(true);
         p->state = State::Stopped;
+        publishTableNoLock();
+        const auto budget = budgetNoLock(p.get());
 
         lk.unlock();
-        (void) stopFn(handle);
-        destroyFn(handle);
+        retireInstance(p.get(), std::move(inst), budget);
         lk.lock();
 
-        p->lib.unload();
+        // Never unload code a hung call may still be running in.
+        if (p->abandoned.empty() && p->reaping.load() == 0) {
+            p->lib.unload();
+        } else {
+            Logger::warn("[PLUGIN] Keeping " + p->id + " loaded: a hung call is still inside it");
+        }
     }
 
+    // Tables still pinned by readers keep their Loaded alive; all handles are detached.
     plugins_.clear();
     byId_.clear();
+    publishTableNoLock();
     pluginsDir_.clear();
     hostCtx_ = nullptr;
 }
 
-QJsonObject PluginManager::readAll() {
-    QJsonObject out;
+// One readAll() fan-out, shared with its read jobs (which may outlive it).
+struct PluginManager::ReadBatch {
+    std::shared_ptr<const Table> table;
+    bool all = true;       // every plugin
+    bool withHost = true;  // append the kHostModuleId module
+    QSet<QString> only;
+    qint64 nowMs = 0;
+
+    std::mutex mu;
+    size_t pending = 1;  // the jobs, plus beginReadAll() until it has started them all
+    bool finished = false;
+    ReadDone done;
+    std::vector<char> wanted;
+    std::vector<char> started;
+    std::vector<char> doneReads;
+    std::vector<char> late;  // the pool lent a thread in place of this job
+};
+
+void PluginManager::readJobDone(const std::shared_ptr<ReadBatch> &batch, size_t i) {
+    ReadDone done; {
+        std::lock_guard<std::mutex> g(batch->mu);
+        if (i < batch->doneReads.size()) {
+            batch->doneReads[i] = 1;
+            if (batch->late[i]) resizeReadPool(-1);
+        }
+        if (--batch->pending == 0 && !batch->finished) done = std::move(batch->done);
+    }
+    if (done) done();
+}
 
-    // Iterate by index so the pointer stays stable while unlocked.
-    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+std::shared_ptr<PluginManager::ReadBatch> PluginManager::beginReadAll(const QSet<QString> *only, ReadDone done) {
+    // Runs against the published table: no mu_, no inFlight/cv_ traffic.
+    auto batch = std::make_shared<ReadBatch>();
+    batch->table = table_.load(std::memory_order_acquire);
+    batch->all = !only || only->contains(QStringLiteral("*"));
+    batch->withHost = !only || only->contains(kHostModuleId);
+    if (only) batch->only = *only;
+    batch->nowMs = QDateTime::currentMSecsSinceEpoch();
+    batch->done = std::move(done);
+
+    const size_t n = batch->table ? batch->table->entries.size() : 0;
+    batch->wanted.assign(n, 0);
+    batch->started.assign(n, 0);
+    batch->doneReads.assign(n, 0);
+    batch->late.assign(n, 0);
+
+    for (size_t i = 0; i < n; i++) {
+        const TableEntry &e = batch->table->entries[i];
+        if (e.state != State::Running || !e.inst || !e.p->read) continue;
+        if (!batch->all && !only->contains(e.p->id)) continue;
+        batch->wanted[i] = 1;
+
+        // Still busy with a read that missed an earlier deadline: do not stack another.
+        if (e.inst->reading.exchange(true, std::memory_order_acquire)) continue;
+
+        { std::lock_guard<std::mutex> g(batch->mu); batch->pending++; }
+        batch->started[i] = 1;
+        readPool_.start([this, batch, i, plugin = e.p, inst = e.inst] {
+            readPlugin(plugin.get(), inst.get(), batch->nowMs);
+            readJobDone(batch, i);
+        });
+    }
 
-    for (size_t i = 0;; i++) {
-        FnRead readFn = nullptr;
-        void *handle = nullptr;
-        QString id;
-        Loaded *p = nullptr; {
-            std::unique_lock<std::mutex> lk(mu_);
-            if (i >= plugins_.size()) break;
-            p = plugins_[i].get();
-            if (!p || !p->info || !p->handle || !p->read) continue;
-            if (p->state != State::Running) continue;
+    readJobDone(batch, (size_t) -1);
+    return batch;
+}
 
-            p->inFlight.fetch_add(1, std::memory_order_relaxed);
-            p->reads++;
-            p->lastReadMs = nowMs;
+std::vector<PluginManager::ModuleJson> PluginManager::finishReadAll(const std::shared_ptr<ReadBatch> &batch,
+                                                                    QSet<QString> *live) {
+    std::vector<ModuleJson> out;
+    if (!batch) return out;
+
+    std::vector<char> done; {
+        std::lock_guard<std::mutex> g(batch->mu);
+        batch->finished = true;
+        batch->done = nullptr;
+        done = batch->doneReads;
+
+        // A late read may never return (a hung wa_read); it keeps its pool thread, so
+        // the pool gets one more until it does and the other plugins are not starved.
+        int late = 0;
+        for (size_t i = 0; i < done.size(); i++) {
+            if (batch->started[i] && !done[i]) {
+                batch->late[i] = 1;
+                late++;
+            }
+        }
+        if (late) resizeReadPool(late);
+    }
 
-            readFn = p->read;
-            handle = p->handle;
-            id = QString::fromUtf8(p->info->id);
+    // Collect in table order so the output does not depend on which read finished first.
+    for (size_t i = 0; i < done.size(); i++) {
+        if (!batch->wanted[i]) continue;
+        Loaded *p = batch->table->entries[i].p.get();
+
+        ModuleJson m;
+        m.id = p->id; {
+            std::lock_guard<std::mutex> g(p->snapMu);
+            m.json = p->lastJson;
+            m.cbor = p->lastCbor;
+            m.changed = p->snapshotDirty;
+            p->snapshotDirty = false;
+        }
+        if (m.json.isEmpty() && m.cbor.isEmpty()) continue;
 
-            lk.unlock();
+        if (!done[i]) {
+            p->readsLate.fetch_add(1, std::memory_order_relaxed);
+            m.stale = true;
+        }
+        out.push_back(std::move(m));
+    }
 
-            const WaView v = readFn(handle);
-            const QJsonObject obj = parseJsonObjectUtf8(v.ptr, v.len);
-            if (!obj.isEmpty()) out[id] = obj;
+    if (batch->withHost) out.push_back(hostModule());
 
-            lk.lock();
-            const int left = p->inFlight.fetch_sub(1, std::memory_order_relaxed) - 1;
-            if (left == 0) cv_.notify_all();
+    if (live && batch->table) {
+        live->insert(kHostModuleId);
+        for (const TableEntry &e: batch->table->entries) {
+            // A quarantined plugin is coming back: its module stays.
+            if (e.state == State::Running || e.state == State::Paused || e.quarantined) live->insert(e.p->id);
         }
     }
-
     return out;
 }
 
+uint32_t PluginManager::readDeadlineMs() const {
+    return readDeadlineMs_.load();
+}
+
+// CPU time (user + kernel) of the host process, worker processes not included.
+static uint64_t processCpuUs() {
+#if defined(_WIN32)
+    FILETIME created, exited, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &created, &exited, &kernel, &user)) return 0;
+    const auto ticks = [](const FILETIME &f) {
+        return ((uint64_t) f.dwHighDateTime << 32) | f.dwLowDateTime; // 100 ns units
+    };
+    return (ticks(kernel) + ticks(user)) / 10;
+#else
+    timespec ts{};
+    if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) != 0) return 0;
+    return (uint64_t) ts.tv_sec * 1000000u + (uint64_t) ts.tv_nsec / 1000u;
+#endif
+}
+
+PluginManager::ModuleJson PluginManager::hostModule() {
+    ModuleJson m;
+    m.id = kHostModuleId;
+
+    // Totals move with every tick: a fresh summary once a second is plenty.
+    const int64_t nowUs = steadyUs();
+    const int64_t elapsedUs = nowUs - hostModuleAtUs_;
+    if (!hostModuleJson_.isEmpty() && elapsedUs < 1000000) {
+        m.json = hostModuleJson_;
+        return m;
+    }
+    const bool first = hostModuleJson_.isEmpty();
+
+    // Share of one core over the last interval; counters restart with a new handle.
+    const auto pct = [&](uint64_t cur, uint64_t prev) {
+        if (first || elapsedUs <= 0) return 0.0;
+        const uint64_t delta = cur >= prev ? cur - prev : cur;
+        return std::round(1000.0 * (double) delta / (double) elapsedUs) / 10.0;
+    };
+
+    const uint64_t processUs = processCpuUs();
+    QJsonObject plugins;
+    std::unordered_map<std::string, CostSample> next;
+    for (const PluginUiSnapshot &s: snapshotUi()) {
+        const std::string key = s.id.toStdString();
+        const CostSample now{s.tickCpuUs, s.readTotalUs, s.requestTotalUs};
+        const auto it = hostPrev_.find(key);
+        const CostSample prev = it != hostPrev_.end() ? it->second : now;
+        next[key] = now;
+
+        QJsonObject o;
+        o.insert("state", s.state);
+        if (s.hasCostStats) {
+            o.insert("cpuPct", pct(now.tickCpuUs, prev.tickCpuUs));
+            o.insert("tickCpuUs", (qint64) s.tickCpuUs);
+            o.insert("tickCpuMaxUs", (qint64) s.tickCpuMaxUs);
+        }
+        if (s.countsAllocs) {
+            o.insert("allocs", (qint64) s.allocs);
+            o.insert("allocBytes", (qint64) s.allocBytes);
+            o.insert("allocsLastTick", (qint64) s.allocsLastTick);
+        }
+        o.insert("readPct", pct(now.readTotalUs, prev.readTotalUs));
+        o.insert("requestPct", pct(now.requestTotalUs, prev.requestTotalUs));
+        o.insert("readUs", (qint64) s.readTotalUs);
+        o.insert("requestUs", (qint64) s.requestTotalUs);
+        o.insert("snapshotBytes", (qint64) s.snapshotBytes);
+        o.insert("snapshotBytesTotal", (qint64) s.snapshotBytesTotal);
+        plugins.insert(s.id, o);
+    }
+
+    QJsonObject root;
+    root.insert("processCpuPct", pct(processUs, hostProcessCpuUs_));
+    root.insert("plugins", plugins);
+    {
+        std::lock_guard<std::mutex> g(hostSectionsMu_);
+        for (auto it = hostSections_.begin(); it != hostSections_.end(); ++it) root.insert(it.key(), it.value());
+    }
+
+    hostPrev_.swap(next);
+    hostProcessCpuUs_ = processUs;
+    hostModuleAtUs_ = nowUs;
+    QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Compact);
+    m.changed = json != hostModuleJson_;
+    hostModuleJson_ = std::move(json);
+
+    m.json = hostModuleJson_;
+    return m;
+}
+
+void PluginManager::setHostSection(const QString &key, const QJsonObject &section) {
+    if (key == "plugins" || key == "processCpuPct") return;
+    std::lock_guard<std::mutex> g(hostSectionsMu_);
+    if (section.isEmpty()) hostSections_.remove(key);
+    else hostSections_.insert(key, section);
+}
+
+void PluginManager::readPlugin(Loaded *p, Instance *inst, qint64 nowMs) {
+    // Owns inst->lastGeneration until `reading` is cleared.
+    if (pinHandle(inst)) {
+        const auto t0 = std::chrono::steady_clock::now();
+        inst->readSinceUs.store(steadyUs());
+        p->reads.fetch_add(1, std::memory_order_relaxed);
+        p->lastReadMs.store(nowMs, std::memory_order_relaxed);
+
+        // Unchanged generation -> empty view, nothing to validate. The view is
+        // borrowed until the next read, so changed bytes are copied once here.
+        bool changed = true;
+        uint64_t gen = inst->lastGeneration;
+        uint32_t viewBytes = 0;
+        QByteArray bytes;
+        if (p->read_if_changed) {
+            const WaView v = p->read_if_changed(inst->handle, inst->lastGeneration, &gen);
+            changed = v.ptr && v.len > 0;
+            viewBytes = changed ? v.len : 0;
+            if (changed) bytes = WireFormat::validView(QByteArray(v.ptr, (qsizetype) v.len), inst->format);
+        } else {
+            const WaView v = p->read(inst->handle);
+            const QByteArray raw = QByteArray::fromRawData(v.ptr, v.ptr ? (qsizetype) v.len : 0);
+            changed = raw != inst->lastRaw;
+            viewBytes = (uint32_t) raw.size();
+            if (changed) {
+                inst->lastRaw = QByteArray(raw.constData(), raw.size());
+                bytes = WireFormat::validView(inst->lastRaw, inst->format);
+            }
+        }
+        inst->readSinceUs.store(0);
+
+        if (changed) {
+            p->snapshotBytes.store(viewBytes, std::memory_order_relaxed);
+            p->snapshotBytesTotal.fetch_add(viewBytes, std::memory_order_relaxed);
+            inst->lastGeneration = gen;
+            std::lock_guard<std::mutex> g(p->snapMu);
+            // A read that outlived its (quarantined) handle must not overwrite the successor's data.
+            if (!inst->detached.load()) {
+                const bool isCbor = inst->format == WA_FMT_CBOR;
+                p->lastJson = isCbor ? QByteArray() : bytes;
+                p->lastCbor = isCbor ? bytes : QByteArray();
+                p->snapshotDirty = true;
+            }
+        }
+        unpinHandle(inst);
+
+        const auto us = (uint64_t) std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - t0).count();
+        p->readLastUs.store(us, std::memory_order_relaxed);
+        storeMax(p->readMaxUs, us);
+        p->readTotalUs.fetch_add(recordCall(p, t0), std::memory_order_relaxed);
+    }
+    inst->reading.store(false, std::memory_order_release);
+}
+
+void PluginManager::resizeReadPool(int lateDelta) {
+    std::lock_guard<std::mutex> g(readPoolMu_);
+    readPoolLate_ += lateDelta;
+    readPool_.setMaxThreadCount(readPoolBase_ + readPoolLate_);
+}
+
+void PluginManager::setReadDeadlineMs(uint32_t ms) {
+    if (ms > 0) readDeadlineMs_.store(ms);
+}
+
 QJsonObject PluginManager::request(const QString &id, const QJsonObject &payload) {
-    Loaded *p = nullptr;
-    FnReq reqFn = nullptr;
-    void *handle = nullptr;
+    std::shared_ptr<Loaded> p;
+    std::shared_ptr<Instance> inst;
     QByteArray reqBytes; {
         std::lock_guard<std::mutex> g(mu_);
-        p = findLoadedNoLock(id);
-        if (!p || !p->handle || !p->req) return {};
+        p = findSharedNoLock(id);
+        if (!p || !p->inst || !p->req) return {};
 
-        p->inFlight.fetch_add(1, std::memory_order_relaxed);
-        p->requests++;
-        p->lastRequestMs = QDateTime::currentMSecsSinceEpoch();
+        inst = p->inst;
+        inst->inFlight.fetch_add(1, std::memory_order_relaxed);
+        p->requests.fetch_add(1, std::memory_order_relaxed);
+        p->lastRequestMs.store(QDateTime::currentMSecsSinceEpoch(), std::memory_order_relaxed);
 
-        reqFn = p->req;
-        handle = p->handle;
         reqBytes = QJsonDocument(payload).toJson(QJsonDocument::Compact);
     }
 
-    const WaView v = reqFn(handle, reqBytes.constData());
-    const QJsonObject out = parseJsonObjectUtf8(v.ptr, v.len); {
+    QJsonObject out; {
+        std::lock_guard<std::mutex> g(inst->reqMu);
+        const auto t0 = std::chrono::steady_clock::now();
+        inst->requestSinceUs.store(steadyUs());
+        const WaView v = p->req(inst->handle, reqBytes.constData());
+        out = parseViewObject(v, inst->format);
+        inst->requestSinceUs.store(0);
+        p->requestTotalUs.fetch_add(recordCall(p.get(), t0), std::memory_order_relaxed);
+    }
+    releaseCall(inst.get());
+
+    return out;
+}
+
+bool PluginManager::requestAsync(const QString &id, const QJsonObject &payload, RequestDone done) {
+    std::shared_ptr<Loaded> p;
+    std::shared_ptr<Instance> inst;
+    uint64_t requestId = 0;
+    QByteArray reqBytes; {
         std::lock_guard<std::mutex> g(mu_);
-        // p is stable while plugins_ vector doesn't shrink during runtime
-        if (p) {
-            const int left = p->inFlight.fetch_sub(1, std::memory_order_relaxed) - 1;
-            if (left == 0) cv_.notify_all();
+        p = findSharedNoLock(id);
+        if (!p || !p->inst || !p->req) return false;
+
+        // Held until the completion runs, so stop/restart wait for it.
+        inst = p->inst;
+        inst->inFlight.fetch_add(1, std::memory_order_relaxed);
+        p->requests.fetch_add(1, std::memory_order_relaxed);
+        p->lastRequestMs.store(QDateTime::currentMSecsSinceEpoch(), std::memory_order_relaxed);
+
+        requestId = nextRequestId_++;
+        if (p->req_async) inst->asyncSinceUs[requestId] = steadyUs();
+        reqBytes = QJsonDocument(payload).toJson(QJsonDocument::Compact);
+    }
+
+    if (p->req_async) {
+        auto *pending = new PendingRequest{this, p, inst, inst->format, std::chrono::steady_clock::now(), std::move(done)};
+        if (p->req_async(inst->handle, reqBytes.constData(), requestId, &PluginManager::host_request_done, pending) == WA_OK) {
+            return true;
         }
+        // Refused (e.g. stopping): the plugin will not call back.
+        delete pending;
+        releaseCall(inst.get(), requestId);
+        return false;
     }
 
-    return out;
+    // Plugins without wa_request_async: keep the blocking call off the caller's thread.
+    QThreadPool::globalInstance()->start([this, p, inst, reqBytes, done = std::move(done)] {
+        QJsonObject out; {
+            std::lock_guard<std::mutex> g(inst->reqMu);
+            const auto t0 = std::chrono::steady_clock::now();
+            inst->requestSinceUs.store(steadyUs());
+            const WaView v = p->req(inst->handle, reqBytes.constData());
+            out = parseViewObject(v, inst->format);
+            inst->requestSinceUs.store(0);
+            p->requestTotalUs.fetch_add(recordCall(p.get(), t0), std::memory_order_relaxed);
+        }
+        releaseCall(inst.get());
+        done(out);
+    });
+    return true;
 }
 
-void PluginManager::markSent(const QStringList &pluginIds) {
+void WA_CALL PluginManager::host_request_done(void *user, uint64_t requestId, WaView response) {
+    std::unique_ptr<PendingRequest> pending(static_cast<PendingRequest *>(user));
+    const QJsonObject out = parseViewObject(response, pending->format);
+    pending->plugin->requestTotalUs.fetch_add(recordCall(pending->plugin.get(), pending->t0), std::memory_order_relaxed);
+    pending->self->releaseCall(pending->inst.get(), requestId);
+    if (pending->done) pending->done(out);
+}
+
+bool PluginManager::tickNow(const QString &id, TickDone done) {
+    std::shared_ptr<Loaded> p;
+    std::shared_ptr<Instance> inst; {
+        std::lock_guard<std::mutex> g(mu_);
+        p = findSharedNoLock(id);
+        if (!p || !p->inst || !p->tick_now || p->state != State::Running) return false;
+
+        // Only held for the call: the plugin completes the tick before wa_stop()
+        // returns, so a pending tick never has to block stop/restart.
+        inst = p->inst;
+        inst->inFlight.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    auto *pending = new TickDone(std::move(done));
+    const auto t0 = std::chrono::steady_clock::now();
+    const bool ok = p->tick_now(inst->handle, &PluginManager::host_tick_done, pending) == WA_OK;
+    recordCall(p.get(), t0);
+    if (!ok) delete pending;
+    releaseCall(inst.get());
+    return ok;
+}
+
+void WA_CALL PluginManager::host_tick_done(void *user, uint64_t generation) {
+    Q_UNUSED(generation);
+    std::unique_ptr<TickDone> done(static_cast<TickDone *>(user));
+    if (*done) (*done)();
+}
+
+void PluginManager::releaseCall(Instance *inst, uint64_t asyncRequestId) {
     std::lock_guard<std::mutex> g(mu_);
-    for (const QString &id: pluginIds) {
-        Loaded *p = findLoadedNoLock(id);
-        if (!p) continue;
-        p->sent++;
+    if (asyncRequestId) inst->asyncSinceUs.erase(asyncRequestId);
+    const int left = inst->inFlight.fetch_sub(1, std::memory_order_relaxed) - 1;
+    if (left == 0) cv_.notify_all();
+}
+
+uint64_t PluginManager::recordCall(Loaded *p, std::chrono::steady_clock::time_point t0) {
+    const auto us = (uint64_t) std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - t0).count();
+    p->callUsHist[histBucket(us)].fetch_add(1, std::memory_order_relaxed);
+    storeMax(p->callMaxUs, us);
+    return us;
+}
+
+void PluginManager::markSent(const QStringList &pluginIds) {
+    const std::shared_ptr<const Table> table = table_.load(std::memory_order_acquire);
+    if (!table) return;
+    for (const TableEntry &e: table->entries) {
+        if (pluginIds.contains(e.p->id)) e.p->sent.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void PluginManager::publishTableNoLock() {
+    auto table = std::make_shared<Table>();
+    table->entries.reserve(plugins_.size());
+    for (const auto &p: plugins_) {
+        if (!p || !p->info) continue;
+        table->entries.push_back(TableEntry{p, p->inst, p->state, p->quarantined, p->quarantines});
     }
+    table_.store(std::move(table), std::memory_order_release);
+}
+
+bool PluginManager::pinHandle(Instance *inst) {
+    // seq_cst on both sides: either the writer sees our pin and waits, or we see
+    // `detached` and back off.
+    inst->readers.fetch_add(1);
+    if (!inst->detached.load()) return true;
+    unpinHandle(inst);
+    return false;
+}
+
+void PluginManager::unpinHandle(Instance *inst) {
+    inst->readers.fetch_sub(1);
+}
+
+bool PluginManager::waitNoReaders(Instance *inst, std::chrono::milliseconds timeout) {
+    // `detached` must already be set; mu_ must not be held. Reads are short, so
+    // polling is fine for this rare path.
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (inst->readers.load() != 0) {
+        if (std::chrono::steady_clock::now() >= deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+void PluginManager::retireInstance(Loaded *p, std::shared_ptr<Instance> inst, std::chrono::milliseconds budget) {
+    if (!inst) return;
+    if (waitNoReaders(inst.get(), budget)) {
+        (void) p->stop(inst->handle);
+        p->destroy(inst->handle);
+        return;
+    }
+
+    std::lock_guard<std::mutex> g(mu_);
+    Logger::error("[PLUGIN] Abandoned " + p->id + " handle: a read is still running after the budget");
+    p->abandoned.push_back(std::move(inst));
+    publishTableNoLock();
 }
 
 bool PluginManager::has(const QString &id) const {
@@ -293,10 +961,10 @@ std::vector<PluginManager::PluginDesc> PluginManager::list() const {
     for (const auto &p: plugins_) {
         if (!p || !p->info) continue;
         PluginDesc d;
-        d.id = QString::fromUtf8(p->info->id);
-        d.name = QString::fromUtf8(p->info->name ? p->info->name : p->info->id);
-        d.description = p->info->desc;
-        d.defaultIntervalMs = p->info->defaultIntervalMs;
+        d.id = p->id;
+        d.name = p->name;
+        d.description = p->description;
+        d.defaultIntervalMs = p->defaultIntervalMs;
         d.hasUi = (p->create_widget != nullptr);
         out.push_back(d);
     }
@@ -304,24 +972,80 @@ std::vector<PluginManager::PluginDesc> PluginManager::list() const {
 }
 
 std::vector<PluginManager::PluginUiSnapshot> PluginManager::snapshotUi() const {
-    std::lock_guard<std::mutex> g(mu_);
     std::vector<PluginUiSnapshot> out;
-    out.reserve(plugins_.size());
+    const std::shared_ptr<const Table> table = table_.load(std::memory_order_acquire);
+    if (!table) return out;
+    out.reserve(table->entries.size());
 
-    for (const auto &p: plugins_) {
-        if (!p || !p->info) continue;
+    for (const TableEntry &e: table->entries) {
+        Loaded *p = e.p.get();
         PluginUiSnapshot s;
-        s.id = QString::fromUtf8(p->info->id);
-        s.name = QString::fromUtf8(p->info->name ? p->info->name : p->info->id);
-        s.description = p->info->desc;
-        s.defaultIntervalMs = p->info->defaultIntervalMs;
+        s.id = p->id;
+        s.name = p->name;
+        s.description = p->description;
+        s.defaultIntervalMs = p->defaultIntervalMs;
         s.hasUi = (p->create_widget != nullptr);
-        s.state = (int32_t) p->state;
-        s.reads = p->reads;
-        s.sent = p->sent;
-        s.requests = p->requests;
-        s.lastReadMs = p->lastReadMs;
-        s.lastRequestMs = p->lastRequestMs;
+        s.state = (int32_t) e.state;
+        s.reads = p->reads.load(std::memory_order_relaxed);
+        s.sent = p->sent.load(std::memory_order_relaxed);
+        s.requests = p->requests.load(std::memory_order_relaxed);
+        s.lastReadMs = p->lastReadMs.load(std::memory_order_relaxed);
+        s.lastRequestMs = p->lastRequestMs.load(std::memory_order_relaxed);
+        s.readLastUs = p->readLastUs.load(std::memory_order_relaxed);
+        s.readMaxUs = p->readMaxUs.load(std::memory_order_relaxed);
+        s.readsLate = p->readsLate.load(std::memory_order_relaxed);
+        s.quarantined = e.quarantined;
+        s.quarantines = e.quarantines;
+        s.startup = p->startup;
+
+        uint64_t callHist[WA_TICK_HIST_BUCKETS];
+        for (uint32_t i = 0; i < WA_TICK_HIST_BUCKETS; i++) {
+            callHist[i] = p->callUsHist[i].load(std::memory_order_relaxed);
+            s.calls += callHist[i];
+        }
+        s.callP50Us = histPercentileUs(callHist, 0.50);
+        s.callP95Us = histPercentileUs(callHist, 0.95);
+        s.callP99Us = histPercentileUs(callHist, 0.99);
+        s.callMaxUs = p->callMaxUs.load(std::memory_order_relaxed);
+
+        // In-process this is a few relaxed loads inside the plugin; a worker's stats
+        // are read from its ring, never over IPC. The read pin keeps the handle from
+        // being stopped meanwhile.
+        WaTickStats ts{};
+        if (e.inst && p->get_tick_stats && pinHandle(e.inst.get())) {
+            s.hasTickStats = p->get_tick_stats(e.inst->handle, &ts) == WA_OK;
+            unpinHandle(e.inst.get());
+        }
+        if (s.hasTickStats) {
+            s.ticks = ts.ticks;
+            s.tickOverruns = ts.overruns;
+            s.tickSkipped = ts.skipped;
+            s.tickLastUs = ts.lastTickUs;
+            s.tickMaxUs = ts.maxTickUs;
+            s.tickP50Us = histPercentileUs(ts.tickUsHist, 0.50);
+            s.tickP95Us = histPercentileUs(ts.tickUsHist, 0.95);
+            s.jitterP95Us = histPercentileUs(ts.jitterUsHist, 0.95);
+            s.jitterMaxUs = ts.maxJitterUs;
+        }
+
+        WaCostStats cs{};
+        if (e.inst && p->get_cost_stats && pinHandle(e.inst.get())) {
+            s.hasCostStats = p->get_cost_stats(e.inst->handle, &cs) == WA_OK;
+            unpinHandle(e.inst.get());
+        }
+        if (s.hasCostStats) {
+            s.countsAllocs = (cs.flags & WA_COST_ALLOCS) != 0;
+            s.tickCpuUs = cs.tickCpuUs;
+            s.tickCpuLastUs = cs.lastTickCpuUs;
+            s.tickCpuMaxUs = cs.maxTickCpuUs;
+            s.allocs = cs.allocs;
+            s.allocBytes = cs.allocBytes;
+            s.allocsLastTick = cs.lastTickAllocs;
+        }
+        s.readTotalUs = p->readTotalUs.load(std::memory_order_relaxed);
+        s.requestTotalUs = p->requestTotalUs.load(std::memory_order_relaxed);
+        s.snapshotBytes = p->snapshotBytes.load(std::memory_order_relaxed);
+        s.snapshotBytesTotal = p->snapshotBytesTotal.load(std::memory_order_relaxed);
         out.push_back(s);
     }
 
@@ -329,108 +1053,365 @@ std::vector<PluginManager::PluginUiSnapshot> PluginManager::snapshotUi() const {
 }
 
 QWidget *PluginManager::createWidget(const QString &id, QWidget *parent) const {
-    FnCreateWidget fn = nullptr;
-    void *handle = nullptr;
-    Loaded *p = nullptr; {
+    std::shared_ptr<Loaded> p;
+    std::shared_ptr<Instance> inst; {
         std::lock_guard<std::mutex> g(mu_);
-        p = findLoadedNoLock(id);
-        if (!p || !p->handle || !p->create_widget) return nullptr;
-        fn = p->create_widget;
-        handle = p->handle;
-        p->inFlight.fetch_add(1, std::memory_order_relaxed);
+        p = findSharedNoLock(id);
+        if (!p || !p->inst || !p->create_widget) return nullptr;
+        inst = p->inst;
+        inst->inFlight.fetch_add(1, std::memory_order_relaxed);
     }
 
-    QWidget *w = fn(handle, parent); {
+    const auto t0 = std::chrono::steady_clock::now();
+    QWidget *w = p->create_widget(inst->handle, parent);
+    recordCall(p.get(), t0); {
         std::lock_guard<std::mutex> g(mu_);
-        if (p) {
-            const int left = p->inFlight.fetch_sub(1, std::memory_order_relaxed) - 1;
-            if (left == 0) cv_.notify_all();
-        }
+        const int left = inst->inFlight.fetch_sub(1, std::memory_order_relaxed) - 1;
+        if (left == 0) cv_.notify_all();
     }
 
     return w;
 }
 
-void PluginManager::waitNoInflight(std::unique_lock<std::mutex> &lk, PluginManager::Loaded *p, std::condition_variable &cv) {
-    if (!p) return;
-    cv.wait(lk, [&] { return p->inFlight.load(std::memory_order_relaxed) == 0; });
+bool PluginManager::waitNoInflight(std::unique_lock<std::mutex> &lk, PluginManager::Loaded *p, std::condition_variable &cv) {
+    if (!p) return true;
+    const auto deadline = std::chrono::steady_clock::now() + budgetNoLock(p);
+    const bool idle = cv.wait_until(lk, deadline, [&] {
+        return !p->inst || p->inst->inFlight.load(std::memory_order_relaxed) == 0;
+    });
+    if (idle) return true;
+
+    quarantineNoLock(p, "a call did not return within the budget");
+    return false;
 }
 
+// ---- Call watchdog ----
 
-int32_t PluginManager::startPlugin(const QString &id) {
-    std::unique_lock<std::mutex> lk(mu_);
-    Loaded *p = findLoadedNoLock(id);
-    if (!p) return WA_ERR_BAD_ARG;
+void PluginManager::setCallBudgetMs(uint32_t ms) {
+    if (ms > 0) callBudgetMs_.store(ms);
+}
 
-    if (p->state == State::Running) return WA_OK;
+std::chrono::milliseconds PluginManager::budgetNoLock(const Loaded *p) const {
+    return std::chrono::milliseconds(p->callBudgetMs ? p->callBudgetMs : callBudgetMs_.load());
+}
 
-    waitNoInflight(lk, p, cv_);
+void PluginManager::quarantineNoLock(Loaded *p, const QString &why) {
+    std::shared_ptr<Instance> inst = std::move(p->inst);
+    if (!inst) return;
+
+    // The handle is never stopped or destroyed while a call may be inside it; the
+    // watchdog reaps it once its calls have returned. A worker process is killed
+    // instead, which fails those calls at once.
+    inst->detached.store(true);
+    if (p->worker) PluginWorker::kill(inst->handle);
+    p->abandoned.push_back(std::move(inst));
+    p->state = State::Error;
+    p->quarantined = true;
+    publishTableNoLock();
+    cv_.notify_all(); // waiters on the abandoned instance's inFlight
+
+    Logger::error("[PLUGIN] Quarantined " + p->id + ": " + why);
+}
 
-    // Resume if supported and currently paused
-    if (p->state == State::Paused && p->resume && p->handle) {
-        void *handle = p->handle;
-        auto resumeFn = p->resume;
+void PluginManager::startWatchdog() {
+    std::lock_guard<std::mutex> g(mu_);
+    if (watchdog_.joinable()) return;
+    watchdogStop_ = false;
+    watchdog_ = std::thread(&PluginManager::watchdogMain, this);
+}
+
+void PluginManager::stopWatchdog() {
+    {
+        std::lock_guard<std::mutex> g(mu_);
+        watchdogStop_ = true;
+    }
+    watchdogCv_.notify_all();
+    if (watchdog_.joinable()) watchdog_.join();
+    controlPool_.waitForDone();
+}
+
+// A plugin running this long without a watchdog quarantine starts over with its restarts.
+static constexpr int64_t kCleanRunUs = 10 * 60 * 1000000LL;
+
+void PluginManager::watchdogMain() {
+    using Reap = std::pair<std::shared_ptr<Loaded>, std::shared_ptr<Instance>>;
+
+    std::unique_lock<std::mutex> lk(mu_);
+    while (!watchdogStop_) {
+        watchdogCv_.wait_for(lk, std::chrono::milliseconds(250), [&] { return watchdogStop_; });
+        if (watchdogStop_) break;
+
+        const int64_t nowUs = steadyUs();
+        QStringList restart;
+        std::vector<Reap> reap;
+
+        for (const auto &p: plugins_) {
+            if (const std::shared_ptr<Instance> inst = p->inst) {
+                int64_t since = 0;
+                const auto oldest = [&since](int64_t t) {
+                    if (t && (!since || t < since)) since = t;
+                };
+                oldest(inst->readSinceUs.load());
+                oldest(inst->requestSinceUs.load());
+                for (const auto &it: inst->asyncSinceUs) oldest(it.second);
+
+                const int64_t budgetUs = (int64_t) budgetNoLock(p.get()).count() * 1000;
+                if (p->worker && PluginWorker::exited(inst->handle)) {
+                    // Crashed or killed from outside: a running plugin gets a fresh process.
+                    const bool wasRunning = p->state == State::Running;
+                    p->quarantines++;
+                    quarantineNoLock(p.get(), "worker process " + PluginWorker::exitReason(inst->handle));
+                    if (wasRunning && p->quarantines <= kMaxAutoRestarts) restart << p->id;
+                } else if (since && nowUs - since > budgetUs) {
+                    p->quarantines++;
+                    quarantineNoLock(p.get(), QString("call running for %1 ms").arg((qint64) ((nowUs - since) / 1000)));
+                    if (p->quarantines <= kMaxAutoRestarts) restart << p->id;
+                } else if (p->quarantines > 0 && p->state == State::Running && nowUs - p->liveSinceUs > kCleanRunUs) {
+                    // Ran clean long enough: a later hang gets the full set of restarts again.
+                    p->quarantines = 0;
+                    publishTableNoLock();
+                }
+            }
+
+            // Abandoned handles whose calls finally returned can be stopped now.
+            for (auto it = p->abandoned.begin(); it != p->abandoned.end();) {
+                Instance *a = it->get();
+                if (a->inFlight.load() == 0 && a->readers.load() == 0 && a->asyncSinceUs.empty()) {
+                    p->reaping.fetch_add(1);
+                    reap.emplace_back(p, std::move(*it));
+                    it = p->abandoned.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
         lk.unlock();
-        const int32_t rc = resumeFn(handle);
+
+        for (const QString &id: restart) {
+            Logger::warn("[PLUGIN] Restarting quarantined plugin: " + id);
+            controlPool_.start([this, id] { (void) restartPlugin(id); });
+        }
+        for (Reap &r: reap) {
+            // wa_stop may block as well: keep it off the watchdog thread.
+            QThreadPool::globalInstance()->start([p = std::move(r.first), inst = std::move(r.second)] {
+                (void) p->stop(inst->handle);
+                p->destroy(inst->handle);
+                p->reaping.fetch_sub(1);
+            });
+        }
+
         lk.lock();
-        if (rc == WA_OK) p->state = State::Running;
-        return rc;
     }
+}
 
-    // Otherwise: full recreate
-    void *oldHandle = p->handle;
-    auto stopFn = p->stop;
-    auto destroyFn = p->destroy;
+uint32_t PluginManager::demandForNoLock(const QString &id) const {
+    uint32_t flags = 0;
+    if (demandClients_ > 0) {
+        flags |= WA_DEMAND_CLIENTS;
+        if (demandAllModules_ || demandModules_.contains(id)) flags |= WA_DEMAND_SUBSCRIBED;
+    }
+    if (guiVisible_) flags |= WA_DEMAND_GUI;
+    return flags;
+}
 
-    p->handle = nullptr;
-    p->state = State::Stopped;
+uint32_t PluginManager::demandFor(const QString &id) const {
+    std::lock_guard<std::mutex> g(mu_);
+    return demandForNoLock(id);
+}
+
+void PluginManager::setClientDemand(int clients, const QSet<QString> *modules) {
+    {
+        std::lock_guard<std::mutex> g(mu_);
+        demandClients_ = clients;
+        demandAllModules_ = modules == nullptr;
+        demandModules_ = modules ? *modules : QSet<QString>();
+    }
+    publishDemand();
+}
+
+void PluginManager::setGuiVisible(bool visible) {
+    {
+        std::lock_guard<std::mutex> g(mu_);
+        if (guiVisible_ == visible) return;
+        guiVisible_ = visible;
+    }
+    publishDemand();
+}
+
+void PluginManager::publishDemand() {
+    // One publisher at a time, so a slower caller cannot overwrite newer bits.
+    std::lock_guard<std::mutex> order(demandPushMu_);
+
+    struct Push {
+        std::shared_ptr<Loaded> p;
+        std::shared_ptr<Instance> inst;
+        uint32_t flags;
+    };
+    std::vector<Push> pushes; {
+        std::lock_guard<std::mutex> g(mu_);
+        for (auto &p: plugins_) {
+            if (!p || !p->inst || !p->set_demand) continue;
+            const uint32_t flags = demandForNoLock(p->id);
+            if (flags == p->demand) continue;
+            p->demand = flags;
+            p->inst->inFlight.fetch_add(1, std::memory_order_relaxed);
+            pushes.push_back(Push{p, p->inst, flags});
+        }
+    }
+
+    for (const Push &x: pushes) {
+        const auto t0 = std::chrono::steady_clock::now();
+        x.p->set_demand(x.inst->handle, x.flags);
+        recordCall(x.p.get(), t0);
+        releaseCall(x.inst.get());
+    }
+}
+
+int32_t PluginManager::recreate(std::unique_lock<std::mutex> &lk, const std::shared_ptr<Loaded> &p) {
+    // mu_ held on entry and on return.
+    // Blue/green: the current handle keeps serving reads and requests while the new
+    // one starts; they are swapped once the new one has published a snapshot.
+    if (p->recreating) return WA_ERR_BAD_STATE;
+    p->recreating = true;
 
     const QByteArray cfgJson = readTextFileIfExists(p->configPath);
     void *hostCtx = hostCtx_;
-    auto createFn = p->create;
-    auto initFn = p->init;
-    auto startFn = p->start;
+    const uint32_t demand = demandForNoLock(p->id);
+    const auto budget = budgetNoLock(p.get());
 
     lk.unlock();
-    if (oldHandle) {
-        (void) stopFn(oldHandle);
-        destroyFn(oldHandle);
-    }
 
-    void *newHandle = createFn(hostCtx, cfgJson.isEmpty() ? nullptr : cfgJson.constData());
-    if (!newHandle) {
+    const auto fail = [&](const char *phase) {
+        Logger::error(QString("[PLUGIN] %1() failed while restarting %2").arg(QString(phase), p->id));
         lk.lock();
-        p->state = State::Error;
+        p->recreating = false;
+        // The old handle (if any) simply keeps running.
+        if (!p->inst) {
+            p->state = State::Error;
+            publishTableNoLock();
+        }
         return WA_ERR;
-    }
+    };
 
-    if (initFn(newHandle) != WA_OK) {
-        destroyFn(newHandle);
-        lk.lock();
-        p->state = State::Error;
-        return WA_ERR;
+    const auto deadline = std::chrono::steady_clock::now() + budget;
+    void *newHandle = createHandle(p.get(), hostCtx, cfgJson, budget);
+    if (!newHandle) return fail("create");
+    if (p->worker) PluginWorker::setDeadline(newHandle, deadline);
+
+    if (p->init(newHandle) != WA_OK) {
+        p->destroy(newHandle);
+        return fail("init");
     }
 
-    if (startFn(newHandle) != WA_OK) {
-        destroyFn(newHandle);
-        lk.lock();
-        p->state = State::Error;
-        return WA_ERR;
+    if (p->set_demand) p->set_demand(newHandle, demand);
+
+    if (p->start(newHandle) != WA_OK) {
+        p->destroy(newHandle);
+        return fail("start");
+    }
+    if (p->worker) PluginWorker::setDeadline(newHandle, std::chrono::steady_clock::time_point::max());
+
+    // First snapshot: the tick wa_tick_now completes on. Plugins without it are
+    // swapped in right away.
+    if (p->tick_now) {
+        auto ticked = std::make_shared<std::promise<void>>();
+        auto *pending = new TickDone([ticked] { ticked->set_value(); });
+        std::future<void> first = ticked->get_future();
+        if (p->tick_now(newHandle, &PluginManager::host_tick_done, pending) != WA_OK) {
+            delete pending;
+        } else if (first.wait_for(budget) != std::future_status::ready) {
+            Logger::warn("[PLUGIN] " + p->id + ": no first snapshot within the budget, swapping anyway");
+        }
     }
 
+    auto inst = std::make_shared<Instance>();
+    inst->handle = newHandle;
+    inst->format = p->view_format ? p->view_format(newHandle) : WA_FMT_JSON;
+
     lk.lock();
-    p->handle = newHandle;
+    std::shared_ptr<Instance> oldInst = std::move(p->inst);
+    const bool wasRunning = oldInst && p->state == State::Running;
+    if (oldInst) oldInst->detached.store(true);
+    p->inst = std::move(inst);
     p->state = State::Running;
+    p->demand = demand;
+    p->quarantined = false;
+    p->liveSinceUs = steadyUs();
+    p->callBudgetMs = callBudgetFromConfig(cfgJson);
+    p->recreating = false;
+    publishTableNoLock();
+
+    if (!wasRunning) {
+        // Nothing fresh was being served: do not let the old data linger.
+        std::lock_guard<std::mutex> g(p->snapMu);
+        p->lastJson.clear();
+        p->lastCbor.clear();
+        p->snapshotDirty = false;
+    }
+
+    if (oldInst) {
+        // Retire the old handle off the caller's path. Calls that started on it
+        // before the swap get the budget to return; a hung one leaves it abandoned.
+        p->reaping.fetch_add(1);
+        controlPool_.start([this, p, oldInst, budget] {
+            {
+                std::unique_lock<std::mutex> g(mu_);
+                const bool idle = cv_.wait_for(g, budget, [&] { return oldInst->inFlight.load() == 0; });
+                if (!idle) {
+                    Logger::error("[PLUGIN] Abandoned old " + p->id + " handle: a call is still running after the budget");
+                    p->abandoned.push_back(oldInst);
+                    publishTableNoLock();
+                    p->reaping.fetch_sub(1);
+                    return;
+                }
+            }
+            retireInstance(p.get(), oldInst, budget);
+            p->reaping.fetch_sub(1);
+        });
+    }
     return WA_OK;
 }
 
+int32_t PluginManager::startPlugin(const QString &id) {
+    std::unique_lock<std::mutex> lk(mu_);
+    const std::shared_ptr<Loaded> p = findSharedNoLock(id);
+    if (!p) return WA_ERR_BAD_ARG;
+
+    if (p->state == State::Running) return WA_OK;
+
+    // A hung call quarantines the handle; a fresh one is created below.
+    waitNoInflight(lk, p.get(), cv_);
+
+    // Resume if supported and currently paused
+    if (p->state == State::Paused && p->resume && p->inst) {
+        const std::shared_ptr<Instance> inst = p->inst;
+        lk.unlock();
+        const auto t0 = std::chrono::steady_clock::now();
+        const int32_t rc = p->resume(inst->handle);
+        recordCall(p.get(), t0);
+        lk.lock();
+        if (rc == WA_OK && p->inst == inst) {
+            p->state = State::Running;
+            publishTableNoLock();
+        }
+        return rc;
+    }
+
+    // Otherwise: full recreate
+    const int32_t rc = recreate(lk, p);
+    lk.unlock();
+    if (rc == WA_OK) publishDemand(); // in case demand moved while the plugin was starting
+    return rc;
+}
+
 int32_t PluginManager::stopPlugin(const QString &id) {
     std::unique_lock<std::mutex> lk(mu_);
-    Loaded *p = findLoadedNoLock(id);
+    const std::shared_ptr<Loaded> p = findSharedNoLock(id);
     if (!p) return WA_ERR_BAD_ARG;
 
-    if (!p->handle) {
+    if (!p->inst) {
         p->state = State::Stopped;
+        publishTableNoLock();
         return WA_OK;
     }
 
@@ -439,92 +1420,128 @@ int32_t PluginManager::stopPlugin(const QString &id) {
         return WA_OK;
     }
 
-    waitNoInflight(lk, p, cv_);
+    // A hung call: the handle is quarantined instead of paused.
+    if (!waitNoInflight(lk, p.get(), cv_)) return WA_ERR;
+
+    const std::shared_ptr<Instance> inst = p->inst;
 
     // Prefer pause (keeps plugin handle alive)
     if (p->pause) {
-        void *handle = p->handle;
-        auto pauseFn = p->pause;
-
         // Block reads while pausing
         p->state = State::Paused;
+        publishTableNoLock();
 
         lk.unlock();
-        const int32_t rc = pauseFn(handle);
+        const auto t0 = std::chrono::steady_clock::now();
+        const int32_t rc = p->pause(inst->handle);
+        recordCall(p.get(), t0);
         lk.lock();
-        if (rc != WA_OK) {
+        if (rc != WA_OK && p->inst == inst) {
             p->state = State::Running;
+            publishTableNoLock();
         }
         return rc;
     }
 
-    // No pause: stop and mark stopped (handle kept, but won't be read/broadcast)
-    void *handle = p->handle;
-    auto stopFn = p->stop;
-
+    // No pause: stop and mark stopped (handle kept, but won't be read/broadcast).
+    // A read dispatched from an older table may still be inside wa_read; detaching
+    // turns away late ones and lets us wait for the running one before wa_stop.
     p->state = State::Stopped;
+    inst->detached.store(true);
+    publishTableNoLock();
+    const auto budget = budgetNoLock(p.get());
 
     lk.unlock();
-    const int32_t rc = stopFn(handle);
+    if (!waitNoReaders(inst.get(), budget)) {
+        lk.lock();
+        if (p->inst == inst) quarantineNoLock(p.get(), "a read did not return within the budget");
+        return WA_ERR;
+    }
+    const auto t0 = std::chrono::steady_clock::now();
+    const int32_t rc = p->stop(inst->handle);
+    recordCall(p.get(), t0);
     lk.lock();
-    if (rc != WA_OK) {
+    if (rc != WA_OK && p->inst == inst) {
+        inst->detached.store(false);
         p->state = State::Running;
+        publishTableNoLock();
     }
     return rc;
 }
 
 int32_t PluginManager::restartPlugin(const QString &id) {
     std::unique_lock<std::mutex> lk(mu_);
-    Loaded *p = findLoadedNoLock(id);
+    const std::shared_ptr<Loaded> p = findSharedNoLock(id);
     if (!p) return WA_ERR_BAD_ARG;
 
-    waitNoInflight(lk, p, cv_);
+    const int32_t rc = recreate(lk, p);
+    lk.unlock();
+    if (rc == WA_OK) publishDemand(); // in case demand moved while the plugin was starting
+    return rc;
+}
 
-    void *oldHandle = p->handle;
-    auto stopFn = p->stop;
-    auto destroyFn = p->destroy;
+void PluginManager::startPluginAsync(const QString &id, ControlDone done) {
+    controlPool_.start([this, id, done = std::move(done)] {
+        const int32_t rc = startPlugin(id);
+        if (done) done(rc);
+    });
+}
 
-    p->handle = nullptr;
-    p->state = State::Stopped;
+void PluginManager::stopPluginAsync(const QString &id, ControlDone done) {
+    controlPool_.start([this, id, done = std::move(done)] {
+        const int32_t rc = stopPlugin(id);
+        if (done) done(rc);
+    });
+}
 
-    const QByteArray cfgJson = readTextFileIfExists(p->configPath);
-    void *hostCtx = hostCtx_;
-    auto createFn = p->create;
-    auto initFn = p->init;
-    auto startFn = p->start;
+void PluginManager::restartPluginAsync(const QString &id, ControlDone done) {
+    controlPool_.start([this, id, done = std::move(done)] {
+        const int32_t rc = restartPlugin(id);
+        if (done) done(rc);
+    });
+}
 
-    lk.unlock();
+int32_t PluginManager::reconfigurePlugin(const QString &id) {
+    std::shared_ptr<Loaded> p;
+    std::shared_ptr<Instance> inst;
+    QByteArray cfgJson; {
+        std::lock_guard<std::mutex> g(mu_);
+        p = findSharedNoLock(id);
+        if (!p) return WA_ERR_BAD_ARG;
+        cfgJson = readTextFileIfExists(p->configPath);
 
-    if (oldHandle) {
-        (void) stopFn(oldHandle);
-        destroyFn(oldHandle);
+        if (p->configure && p->inst && (p->state == State::Running || p->state == State::Paused)) {
+            inst = p->inst;
+            inst->inFlight.fetch_add(1, std::memory_order_relaxed);
+        }
     }
 
-    void *newHandle = createFn(hostCtx, cfgJson.isEmpty() ? nullptr : cfgJson.constData());
-    if (!newHandle) {
-        lk.lock();
-        p->state = State::Error;
-        return WA_ERR;
-    }
+    if (inst) {
+        // Keeps the warm handle: the plugin swaps the config in between two ticks.
+        const auto t0 = std::chrono::steady_clock::now();
+        const int32_t rc = p->configure(inst->handle, cfgJson.isEmpty() ? "{}" : cfgJson.constData());
+        recordCall(p.get(), t0);
+        releaseCall(inst.get());
 
-    if (initFn(newHandle) != WA_OK) {
-        destroyFn(newHandle);
-        lk.lock();
-        p->state = State::Error;
-        return WA_ERR;
+        if (rc == WA_OK) {
+            {
+                std::lock_guard<std::mutex> g(mu_);
+                p->callBudgetMs = callBudgetFromConfig(cfgJson);
+            }
+            Logger::info("[PLUGIN] Reconfigured: " + id);
+            return WA_OK;
+        }
+        Logger::info("[PLUGIN] " + id + " cannot apply the config live, restarting");
     }
 
-    if (startFn(newHandle) != WA_OK) {
-        destroyFn(newHandle);
-        lk.lock();
-        p->state = State::Error;
-        return WA_ERR;
-    }
+    return restartPlugin(id);
+}
 
-    lk.lock();
-    p->handle = newHandle;
-    p->state = State::Running;
-    return WA_OK;
+void PluginManager::reconfigurePluginAsync(const QString &id, ControlDone done) {
+    controlPool_.start([this, id, done = std::move(done)] {
+        const int32_t rc = reconfigurePlugin(id);
+        if (done) done(rc);
+    });
 }
 
 int32_t PluginManager::pluginState(const QString &id) const {
@@ -556,5 +1573,61 @@ int32_t WA_CALL PluginManager::host_stop(void *user, const char *pluginIdUtf8) {
 int32_t WA_CALL PluginManager::host_restart(void *user, const char *pluginIdUtf8) {
     auto *pm = static_cast<PluginManager *>(user);
     if (!pm || !pluginIdUtf8) return WA_ERR_BAD_ARG;
-    return pm->restartPlugin(QString::fromUtf8(pluginIdUtf8));
+    // A restart waits for the new handle's first snapshot; plugin UIs call this on
+    // the GUI thread. Queue it like the overview's restart button does.
+    const QString id = QString::fromUtf8(pluginIdUtf8);
+    if (pm->pluginState(id) == WA_STATE_MISSING) return WA_ERR_BAD_ARG;
+    pm->restartPluginAsync(id, [id](int32_t rc) {
+        if (rc != WA_OK) Logger::error("[PLUGIN] restart failed: " + id);
+    });
+    return WA_OK;
+}
+
+int32_t WA_CALL PluginManager::host_reconfigure(void *user, const char *pluginIdUtf8) {
+    auto *pm = static_cast<PluginManager *>(user);
+    if (!pm || !pluginIdUtf8) return WA_ERR_BAD_ARG;
+    // Plugin UIs call this from their Save button on the GUI thread: queue it and
+    // return; the outcome lands in the log.
+    const QString id = QString::fromUtf8(pluginIdUtf8);
+    if (pm->pluginState(id) == WA_STATE_MISSING) return WA_ERR_BAD_ARG;
+    pm->reconfigurePluginAsync(id, [id](int32_t rc) {
+        if (rc != WA_OK) Logger::error("[PLUGIN] reconfigure failed: " + id);
+    });
+    return WA_OK;
+}
+
+uint64_t WA_CALL PluginManager::host_sched_register(void *user, WaTaskFn fn, void *taskUser, uint32_t intervalMs) {
+    auto *pm = static_cast<PluginManager *>(user);
+    if (!pm || !fn) return 0;
+    return pm->scheduler_.add(fn, taskUser, intervalMs);
+}
+
+void WA_CALL PluginManager::host_sched_unregister(void *user, uint64_t taskId) {
+    auto *pm = static_cast<PluginManager *>(user);
+    if (!pm) return;
+    pm->scheduler_.remove(taskId);
+}
+
+void WA_CALL PluginManager::host_sched_set_interval(void *user, uint64_t taskId, uint32_t intervalMs) {
+    auto *pm = static_cast<PluginManager *>(user);
+    if (!pm) return;
+    pm->scheduler_.setInterval(taskId, intervalMs);
+}
+
+void WA_CALL PluginManager::host_sched_set_active(void *user, uint64_t taskId, int32_t active) {
+    auto *pm = static_cast<PluginManager *>(user);
+    if (!pm) return;
+    pm->scheduler_.setActive(taskId, active != 0);
+}
+
+void WA_CALL PluginManager::host_sched_wake(void *user, uint64_t taskId) {
+    auto *pm = static_cast<PluginManager *>(user);
+    if (!pm) return;
+    pm->scheduler_.wake(taskId);
+}
+
+uint32_t WA_CALL PluginManager::host_demand_get(void *user, const char *pluginIdUtf8) {
+    auto *pm = static_cast<PluginManager *>(user);
+    if (!pm || !pluginIdUtf8) return 0;
+    return pm->demandFor(QString::fromUtf8(pluginIdUtf8));
 }
@@ -270,6 +270,13 @@ void PluginOverviewWidget::syncCards(const std::vector<PluginManager::PluginUiSn
         }
 
         card->setStaticInfo(s.id, s.name, s.description, s.defaultIntervalMs, s.hasUi);
+        card->setStartupTiming(
+            s.startup.loadUs,
+            s.startup.resolveUs,
+            s.startup.createUs,
+            s.startup.initUs,
+            s.startup.startUs
+        );
     }
 
     // Remove cards for plugins that no longer exist.
@@ -299,6 +306,40 @@ void PluginOverviewWidget::updateCards(const std::vector<PluginManager::PluginUi
             s.lastReadMs,
             s.lastRequestMs
         );
+        card->updateTiming(
+            s.hasTickStats,
+            s.ticks,
+            s.tickOverruns,
+            s.tickSkipped,
+            s.tickLastUs,
+            s.tickP50Us,
+            s.tickP95Us,
+            s.tickMaxUs,
+            s.jitterP95Us,
+            s.jitterMaxUs
+        );
+        card->updateReadTiming(s.readLastUs, s.readMaxUs, s.readsLate);
+        card->updateCallTiming(
+            s.calls,
+            s.callP50Us,
+            s.callP95Us,
+            s.callP99Us,
+            s.callMaxUs,
+            s.quarantined,
+            s.quarantines
+        );
+        card->updateCost(
+            s.hasCostStats,
+            s.tickCpuUs,
+            s.tickCpuMaxUs,
+            s.countsAllocs,
+            s.allocs,
+            s.allocBytes,
+            s.readTotalUs,
+            s.requestTotalUs,
+            s.snapshotBytes,
+            s.snapshotBytesTotal
+        );
     }
 }
 
@@ -0,0 +1,628 @@
+#include "PluginWorker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include <QCoreApplication>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QProcess>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
+#include <QtEndian>
+
+#include "Logger.h"
+#include "SnapshotRing.h"
+
+static_assert(sizeof(WorkerIpc::Stats) <= SnapshotRing::kStatsBytes);
+
+// ---- Wire helpers ----
+QByteArray WorkerIpc::frame(Op op, quint64 id, const QByteArray &fields) {
+    const quint32 bodySize = (quint32) (1 + 8 + fields.size());
+    QByteArray out(4 + 1 + 8, Qt::Uninitialized);
+    uchar *u = reinterpret_cast<uchar *>(out.data());
+    qToLittleEndian<quint32>(bodySize, u);
+    u[4] = (uchar) op;
+    qToLittleEndian<quint64>(id, u + 5);
+    out += fields;
+    return out;
+}
+
+WorkerIpc::Take WorkerIpc::takeFrame(QByteArray &buf, quint32 maxBody, Op &op, quint64 &id, QByteArray &fields) {
+    if (buf.size() < 4) return Take::Incomplete;
+    const auto *u = reinterpret_cast<const uchar *>(buf.constData());
+    const quint32 bodySize = qFromLittleEndian<quint32>(u);
+    if (bodySize < 9 || bodySize > maxBody) {
+        buf.clear(); // not our protocol (or runaway): never buffer toward it
+        return Take::Invalid;
+    }
+    if ((quint64) buf.size() < 4ull + bodySize) return Take::Incomplete;
+
+    op = (Op) u[4];
+    id = qFromLittleEndian<quint64>(u + 5);
+    fields = buf.mid(13, (qsizetype) bodySize - 9);
+    buf.remove(0, 4 + (qsizetype) bodySize);
+    return Take::Frame;
+}
+
+// WorkerProcess
+// -------------
+// Host side of one worker process (= one plugin handle). The QProcess and the
+// sockets live on the io thread; callers on any other thread post frames there
+// and block on `cv` for the matching reply. Once the process is gone every
+// waiting and later call fails at once; so does a call still waiting at the
+// startup deadline (the process is killed).
+class WorkerProcess : public QObject {
+public:
+    explicit WorkerProcess(QThread *io) { moveToThread(io); }
+
+    // ---- io thread ----
+    bool launchOnIo(const QString &exe, const QString &library, uint32_t ringBytes, QString *error);
+    void killOnIo();
+    void retire();
+
+    // ---- any thread except io ----
+    bool waitHello(std::chrono::milliseconds timeout, QString *error);
+    bool call(WorkerIpc::Op op, const QByteArray &fields, QByteArray *reply);
+    int32_t callRc(WorkerIpc::Op op, const QByteArray &fields = {});
+    void post(const QByteArray &frame);
+    bool isDead();
+    void setDeadline(std::chrono::steady_clock::time_point d);
+
+    SnapshotRing ring;
+    WaHostApi *host = nullptr;  // set by create(), before the first HostCall can arrive
+
+    // Views handed back to PluginManager (lifetime: until the next call of the same kind,
+    // which PluginManager already serializes per handle)
+    QByteArray readBuf;
+    QByteArray reqBuf;
+
+    // Hello (valid once `hello` is set)
+    bool helloOk = false;
+    QString helloError;
+    quint32 apiVersion = 0;
+    QByteArray id, name, desc;
+    quint32 defaultIntervalMs = 0;
+    quint32 exports = 0;
+
+    quint32 viewFormat = WA_FMT_JSON;  // set by create()
+
+    std::mutex mu;
+    std::condition_variable cv;
+    bool hello = false;
+    bool dead = false;
+    QString deadWhy;
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    quint32 maxBody = 0;  // set by launchOnIo (from the ring's slot size)
+
+    struct Pending {
+        bool done = false;
+        QByteArray fields;
+    };
+    struct Async {
+        WaRequestDoneFn done = nullptr;
+        void *user = nullptr;
+    };
+    struct Tick {
+        WaTickDoneFn done = nullptr;
+        void *user = nullptr;
+    };
+    quint64 nextId = 1;
+    quint64 nextTick = 1;
+    std::unordered_map<quint64, Pending *> calls;  // waiting callers by frame id
+    std::unordered_map<quint64, Async> asyncs;     // by requestId
+    std::unordered_map<quint64, Tick> ticks;       // by tick id
+
+private:
+    void onReadyRead();
+    void dispatch(WorkerIpc::Op op, quint64 frameId, const QByteArray &fields);
+    void markDead(const QString &why);
+    void finishHostCall(quint64 frameId, qint32 rc);
+    void maybeDelete();
+    static qint32 runHostCall(WaHostApi *api, quint8 fn, const QByteArray &pluginId);
+
+    QProcess *proc_ = nullptr;
+    QLocalServer *server_ = nullptr;
+    QLocalSocket *sock_ = nullptr;
+    QByteArray in_;
+    int hostCalls_ = 0;     // HostCalls running on the pool (keep `this` alive)
+    bool retired_ = false;  // destroyed by the host: delete once the process is gone
+};
+
+bool WorkerProcess::launchOnIo(const QString &exe, const QString &library, uint32_t ringBytes, QString *error) {
+    static std::atomic<uint32_t> seq{0};
+    const QString name = QString("winagent-worker-%1-%2")
+            .arg((qint64) QCoreApplication::applicationPid()).arg((qint64) seq.fetch_add(1));
+    const QString ringKey = name + "-ring";
+
+    if (!ring.create(ringKey, ringBytes)) {
+        *error = "shared memory: " + ring.errorString();
+        return false;
+    }
+    maxBody = WorkerIpc::maxBody(ringBytes);
+
+    server_ = new QLocalServer(this);
+    server_->setSocketOptions(QLocalServer::UserAccessOption);
+    QLocalServer::removeServer(name);
+    if (!server_->listen(name)) {
+        *error = "listen: " + server_->errorString();
+        return false;
+    }
+    connect(server_, &QLocalServer::newConnection, this, [this] {
+        if (sock_) return; // one worker per server
+        sock_ = server_->nextPendingConnection();
+        server_->close();
+        connect(sock_, &QLocalSocket::readyRead, this, &WorkerProcess::onReadyRead);
+        connect(sock_, &QLocalSocket::disconnected, this, [this] { markDead("closed the connection"); });
+        onReadyRead();
+    });
+
+    proc_ = new QProcess(this);
+    proc_->setProcessChannelMode(QProcess::ForwardedChannels);
+    connect(proc_, &QProcess::finished, this, [this](int code, QProcess::ExitStatus status) {
+        markDead(status == QProcess::CrashExit
+                     ? QString("crashed (exit code %1)").arg(code)
+                     : QString("exited with code %1").arg(code));
+        maybeDelete();
+    });
+    connect(proc_, &QProcess::errorOccurred, this, [this](QProcess::ProcessError e) {
+        if (e != QProcess::FailedToStart) return;
+        markDead("failed to start: " + proc_->errorString());
+        maybeDelete();
+    });
+    proc_->start(exe, {"--library", library, "--server", name, "--ring", ringKey});
+    return true;
+}
+
+void WorkerProcess::onReadyRead() {
+    if (!sock_) return;
+    in_ += sock_->readAll();
+
+    WorkerIpc::Op op;
+    quint64 frameId = 0;
+    QByteArray fields;
+    for (;;) {
+        switch (WorkerIpc::takeFrame(in_, maxBody, op, frameId, fields)) {
+            case WorkerIpc::Take::Frame:
+                dispatch(op, frameId, fields);
+                continue;
+            case WorkerIpc::Take::Invalid:
+                // Kills the process; the watchdog quarantines it and spawns a fresh one.
+                markDead("sent an invalid or oversized frame");
+                return;
+            case WorkerIpc::Take::Incomplete:
+                return;
+        }
+    }
+}
+
+void WorkerProcess::dispatch(WorkerIpc::Op op, quint64 frameId, const QByteArray &fields) {
+    switch (op) {
+        case WorkerIpc::Hello: {
+            std::lock_guard<std::mutex> g(mu);
+            WorkerIpc::unpack(fields, helloOk, helloError, apiVersion, id, name, desc, defaultIntervalMs, exports);
+            hello = true;
+            cv.notify_all();
+            return;
+        }
+        case WorkerIpc::Reply: {
+            std::lock_guard<std::mutex> g(mu);
+            const auto it = calls.find(frameId);
+            if (it == calls.end()) return;
+            it->second->fields = fields;
+            it->second->done = true;
+            cv.notify_all();
+            return;
+        }
+        case WorkerIpc::AsyncDone: {
+            quint64 requestId = 0;
+            QByteArray view;
+            WorkerIpc::unpack(fields, requestId, view);
+
+            Async a; {
+                std::lock_guard<std::mutex> g(mu);
+                const auto it = asyncs.find(requestId);
+                if (it == asyncs.end()) return;
+                a = it->second;
+                asyncs.erase(it);
+            }
+            a.done(a.user, requestId, WaView{view.constData(), (uint32_t) view.size()});
+            return;
+        }
+        case WorkerIpc::TickDone: {
+            quint64 tickId = 0, generation = 0;
+            WorkerIpc::unpack(fields, tickId, generation);
+
+            Tick t; {
+                std::lock_guard<std::mutex> g(mu);
+                const auto it = ticks.find(tickId);
+                if (it == ticks.end()) return;
+                t = it->second;
+                ticks.erase(it);
+            }
+            if (t.done) t.done(t.user, generation);
+            return;
+        }
+        case WorkerIpc::HostCall: {
+            quint8 fn = 0;
+            QByteArray pluginId;
+            WorkerIpc::unpack(fields, fn, pluginId);
+
+            // Host calls may restart this very plugin (and wait for it): never on the io thread.
+            hostCalls_++;
+            QThreadPool::globalInstance()->start([this, frameId, fn, pluginId, api = host] {
+                const qint32 rc = runHostCall(api, fn, pluginId);
+                QMetaObject::invokeMethod(this, [this, frameId, rc] { finishHostCall(frameId, rc); }, Qt::QueuedConnection);
+            });
+            return;
+        }
+        default:
+            return;
+    }
+}
+
+qint32 WorkerProcess::runHostCall(WaHostApi *api, quint8 fn, const QByteArray &pluginId) {
+    if (!api) return fn == WorkerIpc::GetState ? WA_STATE_MISSING : WA_ERR_BAD_STATE;
+    const char *pid = pluginId.constData();
+    switch (fn) {
+        case WorkerIpc::GetState: return api->plugin_get_state(api->user, pid);
+        case WorkerIpc::StartPlugin: return api->plugin_start(api->user, pid);
+        case WorkerIpc::StopPlugin: return api->plugin_stop(api->user, pid);
+        case WorkerIpc::RestartPlugin: return api->plugin_restart(api->user, pid);
+        case WorkerIpc::ReconfigurePlugin:
+            return api->apiVersion >= 4 && api->plugin_reconfigure
+                       ? api->plugin_reconfigure(api->user, pid)
+                       : api->plugin_restart(api->user, pid);
+        case WorkerIpc::GetDemand:
+            return api->apiVersion >= 3 && api->demand_get ? (qint32) api->demand_get(api->user, pid) : 0;
+        default: return WA_ERR_BAD_ARG;
+    }
+}
+
+void WorkerProcess::finishHostCall(quint64 frameId, qint32 rc) {
+    if (sock_) sock_->write(WorkerIpc::frame(WorkerIpc::HostReply, frameId, WorkerIpc::pack(rc)));
+    hostCalls_--;
+    maybeDelete();
+}
+
+void WorkerProcess::markDead(const QString &why) {
+    std::unordered_map<quint64, Async> failedAsync;
+    std::unordered_map<quint64, Tick> failedTicks; {
+        std::lock_guard<std::mutex> g(mu);
+        if (dead) return;
+        dead = true;
+        deadWhy = why;
+        failedAsync.swap(asyncs);
+        failedTicks.swap(ticks);
+        cv.notify_all();
+    }
+    killOnIo();
+
+    // Completions are owed exactly once, also when the worker died with them.
+    for (const auto &[requestId, a]: failedAsync) a.done(a.user, requestId, WaView{nullptr, 0});
+    for (const auto &it: failedTicks) {
+        if (it.second.done) it.second.done(it.second.user, 0);
+    }
+}
+
+void WorkerProcess::killOnIo() {
+    if (proc_ && proc_->state() != QProcess::NotRunning) proc_->kill();
+}
+
+void WorkerProcess::retire() {
+    retired_ = true;
+    if (proc_ && proc_->state() != QProcess::NotRunning) {
+        // The worker exits on its own after Destroy; this is for one that does not.
+        QTimer::singleShot(2000, this, [this] {
+            if (proc_ && proc_->state() != QProcess::NotRunning) proc_->kill();
+        });
+    }
+    maybeDelete();
+}
+
+void WorkerProcess::maybeDelete() {
+    if (!retired_ || hostCalls_ > 0) return;
+    if (proc_ && proc_->state() != QProcess::NotRunning) return;
+    deleteLater();
+}
+
+bool WorkerProcess::waitHello(std::chrono::milliseconds timeout, QString *error) {
+    std::unique_lock<std::mutex> lk(mu);
+    cv.wait_for(lk, timeout, [&] { return hello || dead; });
+    if (hello && helloOk) return true;
+
+    if (hello) *error = helloError;
+    else if (dead) *error = "worker " + deadWhy;
+    else *error = QString("no answer from the worker within %1 ms").arg((qint64) timeout.count());
+    return false;
+}
+
+bool WorkerProcess::isDead() {
+    std::lock_guard<std::mutex> g(mu);
+    return dead;
+}
+
+void WorkerProcess::setDeadline(std::chrono::steady_clock::time_point d) {
+    std::lock_guard<std::mutex> g(mu);
+    deadline = d;
+}
+
+void WorkerProcess::post(const QByteArray &frame) {
+    QMetaObject::invokeMethod(this, [this, frame] {
+        if (sock_) sock_->write(frame);
+    }, Qt::QueuedConnection);
+}
+
+bool WorkerProcess::call(WorkerIpc::Op op, const QByteArray &fields, QByteArray *reply) {
+    // The worker drops a connection that sends more; fail just this call instead.
+    if (9 + (quint64) fields.size() > maxBody) return false;
+
+    Pending pending;
+    quint64 frameId = 0; {
+        std::lock_guard<std::mutex> g(mu);
+        if (dead) return false;
+        frameId = nextId++;
+        calls[frameId] = &pending;
+    }
+    post(WorkerIpc::frame(op, frameId, fields));
+
+    // No timeout past startup: a hung call is the watchdog's business, and it
+    // kills the process, which fails this wait.
+    std::unique_lock<std::mutex> lk(mu);
+    const bool answered = cv.wait_until(lk, deadline, [&] { return pending.done || dead; });
+    calls.erase(frameId);
+    if (!answered) {
+        lk.unlock();
+        PluginWorker::kill(this);
+        return false;
+    }
+    if (!pending.done) return false;
+    if (reply) *reply = std::move(pending.fields);
+    return true;
+}
+
+int32_t WorkerProcess::callRc(WorkerIpc::Op op, const QByteArray &fields) {
+    QByteArray reply;
+    if (!call(op, fields, &reply)) return WA_ERR;
+    qint32 rc = WA_ERR;
+    WorkerIpc::unpack(reply, rc);
+    return rc;
+}
+
+static WorkerProcess *wp(void *handle) {
+    return static_cast<WorkerProcess *>(handle);
+}
+
+// ---- PluginWorker ----
+PluginWorker::PluginWorker(QThread *io, QString workerExe, QString libraryPath, uint32_t ringKiB)
+    : io_(io), exe_(std::move(workerExe)), library_(std::move(libraryPath)),
+      ringBytes_(std::clamp<uint32_t>(ringKiB, 16, 16 * 1024) * 1024) {
+}
+
+PluginWorker::~PluginWorker() {
+    if (spare_) {
+        kill(spare_);
+        QMetaObject::invokeMethod(spare_, [w = spare_] { w->retire(); }, Qt::QueuedConnection);
+    }
+}
+
+WorkerProcess *PluginWorker::launch(std::chrono::milliseconds timeout, QString *error) {
+    auto *w = new WorkerProcess(io_);
+    bool ok = false;
+    QMetaObject::invokeMethod(w, [&] { ok = w->launchOnIo(exe_, library_, ringBytes_, error); },
+                              Qt::BlockingQueuedConnection);
+    if (ok) ok = w->waitHello(timeout, error);
+    if (!ok) {
+        kill(w);
+        QMetaObject::invokeMethod(w, [w] { w->retire(); }, Qt::QueuedConnection);
+        return nullptr;
+    }
+    return w;
+}
+
+bool PluginWorker::probe(std::chrono::milliseconds timeout, QString *error) {
+    WorkerProcess *w = launch(timeout, error);
+    if (!w) return false;
+
+    id_ = w->id;
+    name_ = w->name;
+    desc_ = w->desc;
+    info_.apiVersion = w->apiVersion;
+    info_.id = id_.constData();
+    info_.name = name_.isNull() ? nullptr : name_.constData();
+    info_.desc = desc_.isNull() ? nullptr : desc_.constData();
+    info_.defaultIntervalMs = w->defaultIntervalMs;
+    exports_ = w->exports;
+    spare_ = w;
+    return true;
+}
+
+void *PluginWorker::create(void *hostCtx, const char *configJsonUtf8, std::chrono::milliseconds timeout) {
+    // PluginManager serializes create() per plugin (load, then recreate).
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    WorkerProcess *w = std::exchange(spare_, nullptr);
+    if (!w) {
+        QString err;
+        w = launch(timeout, &err);
+        if (!w) {
+            Logger::error("[PLUGIN] Worker for " + QString::fromUtf8(id_) + " failed: " + err);
+            return nullptr;
+        }
+    }
+
+    w->host = static_cast<WaHostApi *>(hostCtx);
+    const QByteArray cfg = configJsonUtf8 ? QByteArray(configJsonUtf8) : QByteArray();
+    QByteArray reply;
+    qint32 rc = WA_ERR;
+    w->setDeadline(deadline);
+    if (!w->call(WorkerIpc::Create, WorkerIpc::pack(cfg), &reply) ||
+        !WorkerIpc::unpack(reply, rc, w->viewFormat) || rc != WA_OK) {
+        destroy(w);
+        return nullptr;
+    }
+    w->setDeadline(std::chrono::steady_clock::time_point::max());
+    return w;
+}
+
+bool PluginWorker::exited(void *handle) {
+    return wp(handle)->isDead();
+}
+
+QString PluginWorker::exitReason(void *handle) {
+    WorkerProcess *w = wp(handle);
+    std::lock_guard<std::mutex> g(w->mu);
+    return w->deadWhy;
+}
+
+void PluginWorker::kill(void *handle) {
+    // Fails every call waiting on this worker (the watchdog's way out of a hang).
+    QMetaObject::invokeMethod(wp(handle), [w = wp(handle)] { w->killOnIo(); }, Qt::QueuedConnection);
+}
+
+void PluginWorker::setDeadline(void *handle, std::chrono::steady_clock::time_point deadline) {
+    wp(handle)->setDeadline(deadline);
+}
+
+// ---- ABI shims ----
+int32_t WA_CALL PluginWorker::init(void *handle) {
+    return wp(handle)->callRc(WorkerIpc::Init);
+}
+
+int32_t WA_CALL PluginWorker::start(void *handle) {
+    return wp(handle)->callRc(WorkerIpc::Start);
+}
+
+int32_t WA_CALL PluginWorker::pause(void *handle) {
+    return wp(handle)->callRc(WorkerIpc::Pause);
+}
+
+int32_t WA_CALL PluginWorker::resume(void *handle) {
+    return wp(handle)->callRc(WorkerIpc::Resume);
+}
+
+int32_t WA_CALL PluginWorker::stop(void *handle) {
+    WorkerProcess *w = wp(handle);
+    const int32_t rc = w->callRc(WorkerIpc::Stop);
+    // Nothing is left running in a worker that is gone.
+    return w->isDead() ? WA_OK : rc;
+}
+
+void WA_CALL PluginWorker::destroy(void *handle) {
+    WorkerProcess *w = wp(handle);
+    (void) w->call(WorkerIpc::Destroy, {}, nullptr);
+    QMetaObject::invokeMethod(w, [w] { w->retire(); }, Qt::QueuedConnection);
+}
+
+WaView WA_CALL PluginWorker::request(void *handle, const char *requestJsonUtf8) {
+    WorkerProcess *w = wp(handle);
+    QByteArray reply;
+    if (!w->call(WorkerIpc::Request, WorkerIpc::pack(QByteArray(requestJsonUtf8 ? requestJsonUtf8 : "")), &reply)) {
+        return WaView{nullptr, 0};
+    }
+
+    w->reqBuf.clear();
+    WorkerIpc::unpack(reply, w->reqBuf);
+    if (w->reqBuf.isNull()) return WaView{nullptr, 0};
+    return WaView{w->reqBuf.constData(), (uint32_t) w->reqBuf.size()};
+}
+
+WaView WA_CALL PluginWorker::read(void *handle) {
+    return readIfChanged(handle, 0, nullptr);
+}
+
+WaView WA_CALL PluginWorker::readIfChanged(void *handle, uint64_t lastSeenGeneration, uint64_t *generationOut) {
+    WorkerProcess *w = wp(handle);
+    uint64_t gen = 0;
+
+    switch (w->ring.readLatest(lastSeenGeneration, w->readBuf, gen)) {
+        case SnapshotRing::ReadResult::Ok:
+            break;
+        case SnapshotRing::ReadResult::Oversize: {
+            // Larger than a ring slot: the worker keeps a copy for this round-trip.
+            QByteArray reply;
+            quint64 ipcGen = 0;
+            if (!w->call(WorkerIpc::Read, {}, &reply) ||
+                !WorkerIpc::unpack(reply, ipcGen, w->readBuf) || ipcGen == 0) {
+                return WaView{nullptr, 0};
+            }
+            gen = ipcGen;
+            break;
+        }
+        default:
+            return WaView{nullptr, 0};
+    }
+
+    if (gen == lastSeenGeneration) return WaView{nullptr, 0};
+    if (generationOut) *generationOut = gen;
+    return WaView{w->readBuf.constData(), (uint32_t) w->readBuf.size()};
+}
+
+// Stats come from the worker's copy in the ring header: a GUI or server thread
+// asking for them never waits on the worker.
+int32_t WA_CALL PluginWorker::getTickStats(void *handle, WaTickStats *out) {
+    if (!out) return WA_ERR_BAD_ARG;
+    WorkerIpc::Stats st{};
+    if (!wp(handle)->ring.readStats(&st, sizeof st)) return WA_ERR_BAD_STATE;
+    if (st.tickRc == WA_OK) *out = st.tick;
+    return st.tickRc;
+}
+
+int32_t WA_CALL PluginWorker::getCostStats(void *handle, WaCostStats *out) {
+    if (!out) return WA_ERR_BAD_ARG;
+    WorkerIpc::Stats st{};
+    if (!wp(handle)->ring.readStats(&st, sizeof st)) return WA_ERR_BAD_STATE;
+    if (st.costRc == WA_OK) *out = st.cost;
+    return st.costRc;
+}
+
+void WA_CALL PluginWorker::setDemand(void *handle, uint32_t demandFlags) {
+    (void) wp(handle)->callRc(WorkerIpc::SetDemand, WorkerIpc::pack((quint32) demandFlags));
+}
+
+int32_t WA_CALL PluginWorker::requestAsync(void *handle, const char *requestJsonUtf8,
+                                           uint64_t requestId, WaRequestDoneFn done, void *doneUser) {
+    if (!done) return WA_ERR_BAD_ARG;
+    WorkerProcess *w = wp(handle); {
+        std::lock_guard<std::mutex> g(w->mu);
+        if (w->dead) return WA_ERR;
+        w->asyncs[requestId] = WorkerProcess::Async{done, doneUser};
+    }
+
+    const int32_t rc = w->callRc(WorkerIpc::RequestAsync,
+                                 WorkerIpc::pack(QByteArray(requestJsonUtf8 ? requestJsonUtf8 : ""),
+                                                 (quint64) requestId));
+    if (rc == WA_OK) return WA_OK;
+
+    // Refused: done must not run. If the worker died meanwhile, done already ran once.
+    std::lock_guard<std::mutex> g(w->mu);
+    return w->asyncs.erase(requestId) ? rc : WA_OK;
+}
+
+int32_t WA_CALL PluginWorker::tickNow(void *handle, WaTickDoneFn done, void *doneUser) {
+    WorkerProcess *w = wp(handle);
+    quint64 tickId = 0; {
+        std::lock_guard<std::mutex> g(w->mu);
+        if (w->dead) return WA_ERR_BAD_STATE;
+        tickId = w->nextTick++;
+        w->ticks[tickId] = WorkerProcess::Tick{done, doneUser};
+    }
+
+    const int32_t rc = w->callRc(WorkerIpc::TickNow, WorkerIpc::pack(tickId));
+    if (rc == WA_OK) return WA_OK;
+
+    std::lock_guard<std::mutex> g(w->mu);
+    return w->ticks.erase(tickId) ? rc : WA_OK;
+}
+
+int32_t WA_CALL PluginWorker::configure(void *handle, const char *configJsonUtf8) {
+    return wp(handle)->callRc(WorkerIpc::Configure, WorkerIpc::pack(QByteArray(configJsonUtf8 ? configJsonUtf8 : "")));
+}
+
+uint32_t WA_CALL PluginWorker::viewFormat(void *handle) {
+    return wp(handle)->viewFormat;
+}
@@ -0,0 +1,643 @@
+#include "PluginWorker.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#endif
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QLibrary>
+#include <QLocalSocket>
+#include <QThreadPool>
+
+#include "SnapshotRing.h"
+#include "TickScheduler.h"
+
+// Worker side of PluginWorker: loads one plugin library, runs the host's ops on a
+// small pool (so a long wa_request does not hold up wa_set_demand, as in-process)
+// and copies every new snapshot generation, and the plugin's stats, into the shared ring.
+namespace {
+
+class WorkerSide : public QObject {
+public:
+    WorkerSide();
+    ~WorkerSide() override;
+
+    bool open(const QString &libraryPath, const QString &serverName, const QString &ringKey);
+
+private:
+    using FnGetInfo = const WaPluginInfo* (WA_CALL*)();
+    using FnCreate  = void* (WA_CALL*)(void*, const char*);
+    using FnHandle  = int32_t (WA_CALL*)(void*);
+    using FnDestroy = void (WA_CALL*)(void*);
+    using FnRead    = WaView (WA_CALL*)(void*);
+    using FnReq     = WaView (WA_CALL*)(void*, const char*);
+    using FnReqAsync = int32_t (WA_CALL*)(void*, const char*, uint64_t, WaRequestDoneFn, void*);
+    using FnReadIfChanged = WaView (WA_CALL*)(void*, uint64_t, uint64_t*);
+    using FnGetTickStats = int32_t (WA_CALL*)(void*, WaTickStats*);
+    using FnGetCostStats = int32_t (WA_CALL*)(void*, WaCostStats*);
+    using FnSetDemand = void (WA_CALL*)(void*, uint32_t);
+    using FnTickNow = int32_t (WA_CALL*)(void*, WaTickDoneFn, void*);
+    using FnConfigure = int32_t (WA_CALL*)(void*, const char*);
+    using FnViewFormat = uint32_t (WA_CALL*)(void*);
+
+    struct Callback {
+        WorkerSide *self;
+        quint64 id;
+    };
+
+    QString resolve();
+    void send(const QByteArray &frame);
+    void onReadyRead();
+    void onHostGone();
+    void handle(WorkerIpc::Op op, quint64 frameId, const QByteArray &fields);
+    int32_t withHandle(FnHandle fn);
+    QByteArray viewBytes(WaView v, const char *what) const;
+
+    // Snapshot pump
+    void pumpMain();
+    void pumpOnce();
+    void publishStats();
+    void startPump();
+    void stopPump();
+
+    // Host API given to the plugin
+    int32_t hostCall(WorkerIpc::HostFn fn, const char *pluginIdUtf8);
+    static WorkerSide *self(void *user) { return static_cast<WorkerSide *>(user); }
+    static int32_t WA_CALL host_get_state(void *user, const char *id);
+    static int32_t WA_CALL host_start(void *user, const char *id);
+    static int32_t WA_CALL host_stop(void *user, const char *id);
+    static int32_t WA_CALL host_restart(void *user, const char *id);
+    static int32_t WA_CALL host_reconfigure(void *user, const char *id);
+    static uint64_t WA_CALL host_sched_register(void *user, WaTaskFn fn, void *taskUser, uint32_t intervalMs);
+    static void WA_CALL host_sched_unregister(void *user, uint64_t taskId);
+    static void WA_CALL host_sched_set_interval(void *user, uint64_t taskId, uint32_t intervalMs);
+    static void WA_CALL host_sched_set_active(void *user, uint64_t taskId, int32_t active);
+    static void WA_CALL host_sched_wake(void *user, uint64_t taskId);
+    static uint32_t WA_CALL host_demand_get(void *user, const char *id);
+
+    static void WA_CALL asyncDone(void *user, uint64_t requestId, WaView response);
+    static void WA_CALL tickDone(void *user, uint64_t generation);
+
+    QLibrary lib_;
+    FnGetInfo get_info_ = nullptr;
+    FnCreate create_ = nullptr;
+    FnHandle init_ = nullptr, start_ = nullptr, pause_ = nullptr, resume_ = nullptr, stop_ = nullptr;
+    FnDestroy destroy_ = nullptr;
+    FnRead read_ = nullptr;
+    FnReq req_ = nullptr;
+    FnReqAsync req_async_ = nullptr;
+    FnReadIfChanged read_if_changed_ = nullptr;
+    FnGetTickStats get_tick_stats_ = nullptr;
+    FnGetCostStats get_cost_stats_ = nullptr;
+    FnSetDemand set_demand_ = nullptr;
+    FnTickNow tick_now_ = nullptr;
+    FnConfigure configure_ = nullptr;
+    FnViewFormat view_format_ = nullptr;
+    const WaPluginInfo *info_ = nullptr;
+
+    QLocalSocket *sock_ = nullptr;  // main thread
+    QByteArray in_;
+    SnapshotRing ring_;
+    quint32 maxView_ = 0;  // largest view a frame may carry (from the ring's slot size)
+    QThreadPool pool_;
+
+    WaHostApi hostApi_{};
+    TickScheduler scheduler_;
+    std::atomic<uint32_t> demand_{0};
+
+    // The handle: ops and the pump use it shared, create/stop/destroy exclusively.
+    std::shared_mutex handleMu_;
+    void *handle_ = nullptr;
+
+    // Pump (pumpMu_): copies new generations into the ring while started
+    std::thread pump_;
+    std::mutex pumpMu_;
+    std::condition_variable pumpCv_;
+    bool pumpStop_ = false;
+    bool pumpNow_ = false;
+    std::atomic<bool> pumping_{false};
+    std::chrono::milliseconds pumpInterval_{50};
+    std::chrono::steady_clock::time_point statsDue_;  // pump thread
+    uint64_t lastGeneration_ = 0;   // pump thread
+    uint64_t plainGeneration_ = 0;  // pump thread, plugins without wa_read_if_changed
+    QByteArray lastRaw_;            // pump thread
+    uint64_t published_ = 0;        // pumpMu_
+    std::vector<std::pair<quint64, uint64_t>> tickAcks_;  // tick id, generation to wait for
+
+    // Latest snapshot too large for a ring slot (served by the Read op)
+    std::mutex oversizeMu_;
+    uint64_t oversizeGen_ = 0;
+    QByteArray oversize_;
+
+    // HostCalls waiting for their HostReply
+    std::mutex callMu_;
+    std::condition_variable callCv_;
+    bool hostGone_ = false;
+    quint64 nextCall_ = 1;
+    std::unordered_map<quint64, std::pair<bool, qint32>> hostCalls_;
+};
+
+WorkerSide::WorkerSide() {
+    hostApi_.apiVersion = WA_HOST_API_VERSION;
+    hostApi_.user = this;
+    hostApi_.plugin_get_state = &WorkerSide::host_get_state;
+    hostApi_.plugin_start = &WorkerSide::host_start;
+    hostApi_.plugin_stop = &WorkerSide::host_stop;
+    hostApi_.plugin_restart = &WorkerSide::host_restart;
+    hostApi_.sched_register = &WorkerSide::host_sched_register;
+    hostApi_.sched_unregister = &WorkerSide::host_sched_unregister;
+    hostApi_.sched_set_interval = &WorkerSide::host_sched_set_interval;
+    hostApi_.sched_set_active = &WorkerSide::host_sched_set_active;
+    hostApi_.sched_wake = &WorkerSide::host_sched_wake;
+    hostApi_.demand_get = &WorkerSide::host_demand_get;
+    hostApi_.plugin_reconfigure = &WorkerSide::host_reconfigure;
+
+    pool_.setMaxThreadCount(4);
+}
+
+WorkerSide::~WorkerSide() {
+    {
+        std::lock_guard<std::mutex> g(pumpMu_);
+        pumpStop_ = true;
+        pumpCv_.notify_one();
+    }
+    if (pump_.joinable()) pump_.join();
+    {
+        // Nobody answers HostCalls any more
+        std::lock_guard<std::mutex> g(callMu_);
+        hostGone_ = true;
+        callCv_.notify_all();
+    }
+    pool_.waitForDone();
+    scheduler_.shutdown();
+}
+
+QString WorkerSide::resolve() {
+    get_info_ = (FnGetInfo) lib_.resolve("wa_get_info");
+    create_ = (FnCreate) lib_.resolve("wa_create");
+    init_ = (FnHandle) lib_.resolve("wa_init");
+    start_ = (FnHandle) lib_.resolve("wa_start");
+    stop_ = (FnHandle) lib_.resolve("wa_stop");
+    destroy_ = (FnDestroy) lib_.resolve("wa_destroy");
+    read_ = (FnRead) lib_.resolve("wa_read");
+    req_ = (FnReq) lib_.resolve("wa_request");
+
+    pause_ = (FnHandle) lib_.resolve("wa_pause");
+    resume_ = (FnHandle) lib_.resolve("wa_resume");
+    read_if_changed_ = (FnReadIfChanged) lib_.resolve("wa_read_if_changed");
+    get_tick_stats_ = (FnGetTickStats) lib_.resolve("wa_get_tick_stats");
+    get_cost_stats_ = (FnGetCostStats) lib_.resolve("wa_get_cost_stats");
+    req_async_ = (FnReqAsync) lib_.resolve("wa_request_async");
+    set_demand_ = (FnSetDemand) lib_.resolve("wa_set_demand");
+    tick_now_ = (FnTickNow) lib_.resolve("wa_tick_now");
+    configure_ = (FnConfigure) lib_.resolve("wa_configure");
+    view_format_ = (FnViewFormat) lib_.resolve("wa_get_view_format");
+
+    if (!get_info_ || !create_ || !init_ || !start_ || !stop_ || !destroy_ || !read_ || !req_) {
+        return "missing exports";
+    }
+    info_ = get_info_();
+    if (!info_ || !info_->id ||
+        info_->apiVersion != WA_PLUGIN_API_VERSION) {
+        return "invalid plugin info";
+    }
+    return {};
+}
+
+bool WorkerSide::open(const QString &libraryPath, const QString &serverName, const QString &ringKey) {
+    sock_ = new QLocalSocket(this);
+    sock_->connectToServer(serverName);
+    if (!sock_->waitForConnected(5000)) {
+        std::fprintf(stderr, "[WORKER] cannot reach the host: %s\n", qUtf8Printable(sock_->errorString()));
+        return false;
+    }
+    connect(sock_, &QLocalSocket::readyRead, this, &WorkerSide::onReadyRead);
+    connect(sock_, &QLocalSocket::disconnected, this, &WorkerSide::onHostGone);
+
+#if defined(_WIN32)
+    // Only this plugin lives here: its folder can stay on the DLL search path.
+    const QString folder = QFileInfo(libraryPath).absolutePath();
+    SetDllDirectoryW(reinterpret_cast<LPCWSTR>(folder.utf16()));
+#endif
+
+    lib_.setFileName(libraryPath);
+    QString error;
+    if (!lib_.load()) error = "load failed: " + lib_.errorString();
+    if (error.isEmpty()) error = resolve();
+    if (error.isEmpty() && !ring_.attach(ringKey)) error = "shared memory: " + ring_.errorString();
+    maxView_ = WorkerIpc::maxView(ring_.slotBytes());
+
+    const bool ok = error.isEmpty();
+    quint32 exports = 0;
+    if (pause_) exports |= WorkerIpc::HasPause;
+    if (resume_) exports |= WorkerIpc::HasResume;
+    if (read_if_changed_) exports |= WorkerIpc::HasReadIfChanged;
+    if (get_tick_stats_) exports |= WorkerIpc::HasTickStats;
+    if (get_cost_stats_) exports |= WorkerIpc::HasCostStats;
+    if (req_async_) exports |= WorkerIpc::HasRequestAsync;
+    if (set_demand_) exports |= WorkerIpc::HasSetDemand;
+    if (tick_now_) exports |= WorkerIpc::HasTickNow;
+    if (configure_) exports |= WorkerIpc::HasConfigure;
+
+    const WaPluginInfo empty{};
+    const WaPluginInfo &info = ok ? *info_ : empty;
+    sock_->write(WorkerIpc::frame(WorkerIpc::Hello, 0, WorkerIpc::pack(
+        ok, error, (quint32) info.apiVersion,
+        QByteArray(info.id), QByteArray(info.name), QByteArray(info.desc),
+        (quint32) info.defaultIntervalMs, exports)));
+    sock_->flush();
+    if (!ok) {
+        sock_->waitForBytesWritten(1000);
+        return false;
+    }
+
+    // Fast enough to keep up with the tick, cheap while nothing changes.
+    pumpInterval_ = std::chrono::milliseconds(std::clamp<uint32_t>(info_->defaultIntervalMs / 4, 10, 50));
+    pump_ = std::thread(&WorkerSide::pumpMain, this);
+    return true;
+}
+
+void WorkerSide::send(const QByteArray &frame) {
+    QMetaObject::invokeMethod(this, [this, frame] {
+        if (sock_) sock_->write(frame);
+    }, Qt::QueuedConnection);
+}
+
+void WorkerSide::onReadyRead() {
+    in_ += sock_->readAll();
+
+    WorkerIpc::Op op;
+    quint64 frameId = 0;
+    QByteArray fields;
+    for (;;) {
+        const WorkerIpc::Take took = WorkerIpc::takeFrame(in_, WorkerIpc::maxBody(ring_.slotBytes()),
+                                                          op, frameId, fields);
+        if (took == WorkerIpc::Take::Incomplete) return;
+        if (took == WorkerIpc::Take::Invalid) {
+            std::fprintf(stderr, "[WORKER] invalid frame from the host\n");
+            onHostGone(); // does not return
+        }
+        if (op == WorkerIpc::HostReply) {
+            qint32 rc = WA_ERR;
+            WorkerIpc::unpack(fields, rc);
+            std::lock_guard<std::mutex> g(callMu_);
+            const auto it = hostCalls_.find(frameId);
+            if (it != hostCalls_.end()) it->second = {true, rc};
+            callCv_.notify_all();
+            continue;
+        }
+        pool_.start([this, op, frameId, fields] { handle(op, frameId, fields); });
+    }
+}
+
+void WorkerSide::onHostGone() {
+    // The host exited or killed the connection: nothing is left to serve. The OS
+    // releases what the plugin holds; a hung plugin must not keep us alive.
+    std::fflush(stderr);
+    std::_Exit(3);
+}
+
+int32_t WorkerSide::withHandle(FnHandle fn) {
+    std::shared_lock<std::shared_mutex> lk(handleMu_);
+    if (!handle_) return WA_ERR_BAD_STATE;
+    if (!fn) return WA_ERR_BAD_STATE;
+    return fn(handle_);
+}
+
+QByteArray WorkerSide::viewBytes(WaView v, const char *what) const {
+    if (!v.ptr) return {};
+    if (v.len > maxView_) {
+        // The host drops a connection carrying more: this view is lost, not the worker.
+        std::fprintf(stderr, "[WORKER] %s of %u bytes exceeds the %u byte limit, dropped\n",
+                     what, (unsigned) v.len, (unsigned) maxView_);
+        return {};
+    }
+    return QByteArray(v.ptr, (qsizetype) v.len);
+}
+
+void WorkerSide::handle(WorkerIpc::Op op, quint64 frameId, const QByteArray &fields) {
+    QByteArray reply;
+    switch (op) {
+        case WorkerIpc::Create: {
+            QByteArray cfg;
+            WorkerIpc::unpack(fields, cfg);
+            std::unique_lock<std::shared_mutex> lk(handleMu_);
+            if (!handle_) handle_ = create_(&hostApi_, cfg.isNull() ? nullptr : cfg.constData());
+            const quint32 format = handle_ && view_format_ ? view_format_(handle_) : (quint32) WA_FMT_JSON;
+            reply = WorkerIpc::pack((qint32) (handle_ ? WA_OK : WA_ERR), format);
+            break;
+        }
+        case WorkerIpc::Init:
+            reply = WorkerIpc::pack((qint32) withHandle(init_));
+            break;
+        case WorkerIpc::Start: {
+            const int32_t rc = withHandle(start_);
+            if (rc == WA_OK) startPump();
+            reply = WorkerIpc::pack((qint32) rc);
+            break;
+        }
+        case WorkerIpc::Pause:
+            reply = WorkerIpc::pack((qint32) withHandle(pause_));
+            break;
+        case WorkerIpc::Resume:
+            reply = WorkerIpc::pack((qint32) withHandle(resume_));
+            break;
+        case WorkerIpc::Stop: {
+            stopPump();
+            std::unique_lock<std::shared_mutex> lk(handleMu_);
+            reply = WorkerIpc::pack((qint32) (handle_ ? stop_(handle_) : WA_ERR_BAD_STATE));
+            break;
+        }
+        case WorkerIpc::Destroy: {
+            stopPump();
+            {
+                std::unique_lock<std::shared_mutex> lk(handleMu_);
+                if (handle_) destroy_(handle_);
+                handle_ = nullptr;
+            }
+            const QByteArray frame = WorkerIpc::frame(WorkerIpc::Reply, frameId);
+            QMetaObject::invokeMethod(this, [this, frame] {
+                sock_->write(frame);
+                sock_->flush();
+                sock_->waitForBytesWritten(1000);
+                QCoreApplication::quit();
+            }, Qt::QueuedConnection);
+            return;
+        }
+        case WorkerIpc::Request: {
+            QByteArray json;
+            WorkerIpc::unpack(fields, json);
+            std::shared_lock<std::shared_mutex> lk(handleMu_);
+            if (!handle_) {
+                reply = WorkerIpc::pack(QByteArray());
+                break;
+            }
+            reply = WorkerIpc::pack(viewBytes(req_(handle_, json.constData()), "response"));
+            break;
+        }
+        case WorkerIpc::RequestAsync: {
+            QByteArray json;
+            quint64 requestId = 0;
+            WorkerIpc::unpack(fields, json, requestId);
+            std::shared_lock<std::shared_mutex> lk(handleMu_);
+            int32_t rc = WA_ERR_BAD_STATE;
+            if (handle_ && req_async_) {
+                auto *cb = new Callback{this, requestId};
+                rc = req_async_(handle_, json.constData(), requestId, &WorkerSide::asyncDone, cb);
+                if (rc != WA_OK) delete cb;
+            }
+            reply = WorkerIpc::pack((qint32) rc);
+            break;
+        }
+        case WorkerIpc::SetDemand: {
+            quint32 flags = 0;
+            WorkerIpc::unpack(fields, flags);
+            demand_.store(flags);
+            std::shared_lock<std::shared_mutex> lk(handleMu_);
+            if (handle_ && set_demand_) set_demand_(handle_, flags);
+            reply = WorkerIpc::pack((qint32) WA_OK);
+            break;
+        }
+        case WorkerIpc::TickNow: {
+            quint64 tickId = 0;
+            WorkerIpc::unpack(fields, tickId);
+            std::shared_lock<std::shared_mutex> lk(handleMu_);
+            int32_t rc = WA_ERR_BAD_STATE;
+            if (handle_ && tick_now_) {
+                auto *cb = new Callback{this, tickId};
+                rc = tick_now_(handle_, &WorkerSide::tickDone, cb);
+                if (rc != WA_OK) delete cb;
+            }
+            reply = WorkerIpc::pack((qint32) rc);
+            break;
+        }
+        case WorkerIpc::Configure: {
+            QByteArray cfg;
+            WorkerIpc::unpack(fields, cfg);
+            std::shared_lock<std::shared_mutex> lk(handleMu_);
+            const int32_t rc = handle_ && configure_ ? configure_(handle_, cfg.constData()) : WA_ERR_BAD_STATE;
+            reply = WorkerIpc::pack((qint32) rc);
+            break;
+        }
+        case WorkerIpc::Read: {
+            std::lock_guard<std::mutex> g(oversizeMu_);
+            reply = WorkerIpc::pack((quint64) oversizeGen_, oversize_);
+            break;
+        }
+        default:
+            return; // unknown op: no reply, the host never sends one
+    }
+    send(WorkerIpc::frame(WorkerIpc::Reply, frameId, reply));
+}
+
+// ---- Snapshot pump ----
+void WorkerSide::startPump() {
+    pumping_.store(true);
+    std::lock_guard<std::mutex> g(pumpMu_);
+    pumpNow_ = true;
+    pumpCv_.notify_one();
+}
+
+void WorkerSide::stopPump() {
+    // Pending tick acks are answered by the pump once it sees pumping_ cleared.
+    pumping_.store(false);
+    std::lock_guard<std::mutex> g(pumpMu_);
+    pumpNow_ = true;
+    pumpCv_.notify_one();
+}
+
+void WorkerSide::pumpMain() {
+    std::unique_lock<std::mutex> lk(pumpMu_);
+    while (!pumpStop_) {
+        pumpCv_.wait_for(lk, pumpInterval_, [&] { return pumpStop_ || pumpNow_; });
+        if (pumpStop_) break;
+        pumpNow_ = false;
+
+        const bool pumping = pumping_.load();
+        const auto now = std::chrono::steady_clock::now();
+        const bool statsDue = now >= statsDue_;
+        if (pumping || statsDue) {
+            lk.unlock();
+            if (pumping) pumpOnce();
+            if (statsDue) {
+                statsDue_ = now + std::chrono::milliseconds(250);
+                publishStats();
+            }
+            lk.lock();
+        }
+
+        // tick_now completions go out once their generation is in the ring, so the
+        // host's next read sees the fresh snapshot.
+        for (auto it = tickAcks_.begin(); it != tickAcks_.end();) {
+            if (!pumping || !read_if_changed_ || it->second <= published_) {
+                // Plain-read plugins count generations here, not in the plugin
+                const quint64 gen = read_if_changed_ ? it->second : std::max<uint64_t>(published_, 1);
+                send(WorkerIpc::frame(WorkerIpc::TickDone, 0, WorkerIpc::pack(it->first, gen)));
+                it = tickAcks_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+void WorkerSide::pumpOnce() {
+    std::shared_lock<std::shared_mutex> lk(handleMu_);
+    if (!handle_) return;
+
+    uint64_t gen = 0;
+    WaView v{nullptr, 0};
+    if (read_if_changed_) {
+        gen = lastGeneration_;
+        v = read_if_changed_(handle_, lastGeneration_, &gen);
+        if (!v.ptr || v.len == 0 || gen == lastGeneration_) return;
+        lastGeneration_ = gen;
+    } else {
+        v = read_(handle_);
+        const QByteArray raw = QByteArray::fromRawData(v.ptr, v.ptr ? (qsizetype) v.len : 0);
+        if (raw == lastRaw_) return;
+        lastRaw_ = QByteArray(raw.constData(), raw.size());
+        gen = ++plainGeneration_;
+    }
+
+    if (v.len > maxView_) {
+        // Too large even for the Read op: the host keeps the previous snapshot
+        // (tick acks still go out below).
+        std::fprintf(stderr, "[WORKER] snapshot of %u bytes exceeds the %u byte limit, dropped\n",
+                     (unsigned) v.len, (unsigned) maxView_);
+    } else {
+        if (v.len > ring_.slotBytes()) {
+            std::lock_guard<std::mutex> g(oversizeMu_);
+            oversize_ = QByteArray(v.ptr, (qsizetype) v.len);
+            oversizeGen_ = gen;
+        }
+        ring_.publish(gen, v.ptr, v.len);
+    }
+
+    std::lock_guard<std::mutex> g(pumpMu_);
+    published_ = gen;
+}
+
+void WorkerSide::publishStats() {
+    WorkerIpc::Stats st{WA_ERR_BAD_STATE, WA_ERR_BAD_STATE, {}, {}};
+    {
+        std::shared_lock<std::shared_mutex> lk(handleMu_);
+        if (handle_ && get_tick_stats_) st.tickRc = get_tick_stats_(handle_, &st.tick);
+        if (handle_ && get_cost_stats_) st.costRc = get_cost_stats_(handle_, &st.cost);
+    }
+    ring_.publishStats(&st, sizeof st);
+}
+
+// ---- Completions from the plugin ----
+void WA_CALL WorkerSide::asyncDone(void *user, uint64_t requestId, WaView response) {
+    auto *cb = static_cast<Callback *>(user);
+    WorkerSide *w = cb->self;
+    delete cb;
+    const QByteArray bytes = w->viewBytes(response, "response");
+    w->send(WorkerIpc::frame(WorkerIpc::AsyncDone, 0,
+                             WorkerIpc::pack((quint64) requestId, bytes)));
+}
+
+void WA_CALL WorkerSide::tickDone(void *user, uint64_t generation) {
+    auto *cb = static_cast<Callback *>(user);
+    WorkerSide *w = cb->self;
+    const quint64 tickId = cb->id;
+    delete cb;
+
+    if (generation == 0) {
+        w->send(WorkerIpc::frame(WorkerIpc::TickDone, 0, WorkerIpc::pack(tickId, (quint64) 0)));
+        return;
+    }
+    std::lock_guard<std::mutex> g(w->pumpMu_);
+    w->tickAcks_.emplace_back(tickId, generation);
+    w->pumpNow_ = true;
+    w->pumpCv_.notify_one();
+}
+
+// ---- Host API (plugin -> host) ----
+int32_t WorkerSide::hostCall(WorkerIpc::HostFn fn, const char *pluginIdUtf8) {
+    quint64 callId = 0; {
+        std::lock_guard<std::mutex> g(callMu_);
+        if (hostGone_) return fn == WorkerIpc::GetState ? int32_t(WA_STATE_MISSING) : int32_t(WA_ERR);
+        callId = nextCall_++;
+        hostCalls_[callId] = {false, WA_ERR};
+    }
+    send(WorkerIpc::frame(WorkerIpc::HostCall, callId,
+                          WorkerIpc::pack((quint8) fn, QByteArray(pluginIdUtf8 ? pluginIdUtf8 : ""))));
+
+    std::unique_lock<std::mutex> lk(callMu_);
+    callCv_.wait(lk, [&] { return hostGone_ || hostCalls_[callId].first; });
+    const qint32 rc = hostCalls_[callId].first ? hostCalls_[callId].second : WA_ERR;
+    hostCalls_.erase(callId);
+    return rc;
+}
+
+int32_t WA_CALL WorkerSide::host_get_state(void *user, const char *id) {
+    return self(user)->hostCall(WorkerIpc::GetState, id);
+}
+
+int32_t WA_CALL WorkerSide::host_start(void *user, const char *id) {
+    return self(user)->hostCall(WorkerIpc::StartPlugin, id);
+}
+
+int32_t WA_CALL WorkerSide::host_stop(void *user, const char *id) {
+    return self(user)->hostCall(WorkerIpc::StopPlugin, id);
+}
+
+int32_t WA_CALL WorkerSide::host_restart(void *user, const char *id) {
+    return self(user)->hostCall(WorkerIpc::RestartPlugin, id);
+}
+
+int32_t WA_CALL WorkerSide::host_reconfigure(void *user, const char *id) {
+    return self(user)->hostCall(WorkerIpc::ReconfigurePlugin, id);
+}
+
+// The scheduler is local: ticks never cross the process boundary.
+uint64_t WA_CALL WorkerSide::host_sched_register(void *user, WaTaskFn fn, void *taskUser, uint32_t intervalMs) {
+    return self(user)->scheduler_.add(fn, taskUser, intervalMs);
+}
+
+void WA_CALL WorkerSide::host_sched_unregister(void *user, uint64_t taskId) {
+    self(user)->scheduler_.remove(taskId);
+}
+
+void WA_CALL WorkerSide::host_sched_set_interval(void *user, uint64_t taskId, uint32_t intervalMs) {
+    self(user)->scheduler_.setInterval(taskId, intervalMs);
+}
+
+void WA_CALL WorkerSide::host_sched_set_active(void *user, uint64_t taskId, int32_t active) {
+    self(user)->scheduler_.setActive(taskId, active != 0);
+}
+
+void WA_CALL WorkerSide::host_sched_wake(void *user, uint64_t taskId) {
+    self(user)->scheduler_.wake(taskId);
+}
+
+uint32_t WA_CALL WorkerSide::host_demand_get(void *user, const char *id) {
+    WorkerSide *w = self(user);
+    if (!id) return 0;
+    // This plugin's bits are pushed with SetDemand; anyone else's are the host's to answer.
+    if (std::strcmp(id, w->info_->id) == 0) return w->demand_.load();
+    const int32_t rc = w->hostCall(WorkerIpc::GetDemand, id);
+    return rc > 0 ? (uint32_t) rc : 0;
+}
+
+} // namespace
+
+int PluginWorker::workerMain(const QString &libraryPath, const QString &serverName, const QString &ringKey) {
+    WorkerSide side;
+    if (!side.open(libraryPath, serverName, ringKey)) return 2;
+    return QCoreApplication::exec();
+}
@@ -0,0 +1,188 @@
+#include "SnapshotRing.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+struct SnapshotRing::Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t slotBytes;
+    std::atomic<uint64_t> latest;  // newest complete generation, 0 = none
+    std::atomic<uint64_t> statsSeq;  // odd while the writer is inside, 0 = none yet
+    std::atomic<uint32_t> statsLen;
+    char stats[kStatsBytes];
+};
+
+struct SnapshotRing::Slot {
+    std::atomic<uint64_t> seq;  // odd while the writer is inside
+    std::atomic<uint64_t> generation;
+    std::atomic<uint32_t> len;  // kOversize: fetch over IPC
+    // payload (slotBytes) follows
+};
+
+// Both processes map the same bytes: the atomics must not hide a lock.
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+static constexpr size_t alignUp(size_t n) {
+    return (n + 63) & ~size_t(63);
+}
+
+SnapshotRing::~SnapshotRing() {
+    detach();
+}
+
+void SnapshotRing::setKey(const QString &key) {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 6, 0)
+    shm_.setNativeKey(QSharedMemory::legacyNativeKey(key));
+#else
+    shm_.setKey(key);
+#endif
+}
+
+bool SnapshotRing::create(const QString &key, uint32_t slotBytes, uint32_t slotCount) {
+    detach();
+    if (slotCount == 0 || slotBytes == 0) return false;
+
+    const size_t slotStride = alignUp(sizeof(Slot) + slotBytes);
+    const size_t size = alignUp(sizeof(Header)) + slotStride * slotCount;
+
+    setKey(key);
+    if (!shm_.create((qsizetype) size)) return false;
+
+    auto *base = static_cast<char *>(shm_.data());
+    std::memset(base, 0, size);
+    auto *h = new(base) Header{};
+    for (uint32_t i = 0; i < slotCount; i++) {
+        new(base + alignUp(sizeof(Header)) + slotStride * i) Slot{};
+    }
+    h->slotCount = slotCount;
+    h->slotBytes = slotBytes;
+    h->version = kVersion;
+    h->magic = kMagic;
+    return mapHeader();
+}
+
+bool SnapshotRing::attach(const QString &key) {
+    detach();
+    setKey(key);
+    if (!shm_.attach()) return false;
+    if (!mapHeader()) {
+        shm_.detach();
+        return false;
+    }
+    return true;
+}
+
+bool SnapshotRing::mapHeader() {
+    auto *h = static_cast<Header *>(shm_.data());
+    if (!h || h->magic != kMagic || h->version != kVersion || h->slotCount == 0) return false;
+
+    const size_t need = alignUp(sizeof(Header)) + alignUp(sizeof(Slot) + h->slotBytes) * h->slotCount;
+    if ((size_t) shm_.size() < need) return false;
+
+    header_ = h;
+    slotCount_ = h->slotCount;
+    slotBytes_ = h->slotBytes;
+    return true;
+}
+
+void SnapshotRing::detach() {
+    header_ = nullptr;
+    slotCount_ = 0;
+    slotBytes_ = 0;
+    if (shm_.isAttached()) shm_.detach();
+}
+
+SnapshotRing::Slot *SnapshotRing::slot(uint64_t generation) const {
+    auto *base = reinterpret_cast<char *>(header_);
+    const size_t stride = alignUp(sizeof(Slot) + slotBytes_);
+    return reinterpret_cast<Slot *>(base + alignUp(sizeof(Header)) + stride * (generation % slotCount_));
+}
+
+void SnapshotRing::publish(uint64_t generation, const char *data, uint32_t len) {
+    if (!header_ || generation == 0) return;
+
+    Slot *s = slot(generation);
+    const uint64_t seq = s->seq.load(std::memory_order_relaxed);
+    s->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    s->generation.store(generation, std::memory_order_relaxed);
+    if (len <= slotBytes_) {
+        if (len) std::memcpy(reinterpret_cast<char *>(s + 1), data, len);
+        s->len.store(len, std::memory_order_relaxed);
+    } else {
+        s->len.store(kOversize, std::memory_order_relaxed);
+    }
+
+    s->seq.store(seq + 2, std::memory_order_release);
+    header_->latest.store(generation, std::memory_order_release);
+}
+
+SnapshotRing::ReadResult SnapshotRing::readLatest(uint64_t lastSeenGeneration, QByteArray &out,
+                                                  uint64_t &generation) const {
+    if (!header_) return ReadResult::Empty;
+
+    // A few retries are plenty: the writer only comes back to a slot after
+    // `slotCount` newer snapshots.
+    for (int attempt = 0; attempt < 16; attempt++) {
+        const uint64_t gen = header_->latest.load(std::memory_order_acquire);
+        if (gen == 0) return ReadResult::Empty;
+        if (gen == lastSeenGeneration) return ReadResult::Unchanged;
+
+        const Slot *s = slot(gen);
+        const uint64_t seq0 = s->seq.load(std::memory_order_acquire);
+        if (seq0 & 1) continue;
+
+        const uint64_t slotGen = s->generation.load(std::memory_order_relaxed);
+        const uint32_t len = s->len.load(std::memory_order_relaxed);
+        if (slotGen != gen) continue;
+
+        if (len != kOversize) {
+            out.resize((qsizetype) std::min(len, slotBytes_));
+            if (len) std::memcpy(out.data(), reinterpret_cast<const char *>(s + 1), out.size());
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (s->seq.load(std::memory_order_relaxed) != seq0) continue;
+
+        generation = gen;
+        return len == kOversize ? ReadResult::Oversize : ReadResult::Ok;
+    }
+    return ReadResult::Unchanged;
+}
+
+void SnapshotRing::publishStats(const void *data, uint32_t len) {
+    if (!header_ || len > kStatsBytes) return;
+
+    const uint64_t seq = header_->statsSeq.load(std::memory_order_relaxed);
+    header_->statsSeq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::memcpy(header_->stats, data, len);
+    header_->statsLen.store(len, std::memory_order_relaxed);
+
+    header_->statsSeq.store(seq + 2, std::memory_order_release);
+}
+
+bool SnapshotRing::readStats(void *out, uint32_t len) const {
+    if (!header_ || len > kStatsBytes) return false;
+
+    // The writer refreshes a few times a second: a couple of retries always get through.
+    for (int attempt = 0; attempt < 16; attempt++) {
+        const uint64_t seq0 = header_->statsSeq.load(std::memory_order_acquire);
+        if (seq0 == 0) return false;
+        if (seq0 & 1) continue;
+
+        const uint32_t have = header_->statsLen.load(std::memory_order_relaxed);
+        std::memcpy(out, header_->stats, len);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (header_->statsSeq.load(std::memory_order_relaxed) != seq0) continue;
+        return have == len;
+    }
+    return false;
+}
@@ -0,0 +1,218 @@
+#include "TickScheduler.h"
+
+#include <algorithm>
+
+TickScheduler::TickScheduler(unsigned workers) {
+    if (workers == 0) {
+        workers = std::thread::hardware_concurrency();
+        workers = std::clamp(workers, 1u, 8u);
+    }
+    workerCount_ = workers;
+}
+
+TickScheduler::~TickScheduler() {
+    shutdown();
+}
+
+void TickScheduler::ensureThreadsNoLock() {
+    // Threads are started lazily: no plugin opted in -> no extra threads.
+    if (started_ || stopping_) return;
+    started_ = true;
+
+    timerThread_ = std::thread(&TickScheduler::timerMain, this);
+    workers_.reserve(workerCount_);
+    for (unsigned i = 0; i < workerCount_; i++) {
+        workers_.emplace_back(&TickScheduler::workerMain, this);
+    }
+}
+
+void TickScheduler::armNoLock(uint64_t id, Task &t, Clock::time_point due) {
+    t.due = due;
+    t.seq++;
+    const bool newHead = timers_.empty() || due < timers_.top().due;
+    timers_.push(Timer{due, id, t.seq});
+    if (newHead) timerCv_.notify_one();
+}
+
+void TickScheduler::enqueueNoLock(uint64_t id, Task &t) {
+    if (t.queued || t.running) return;
+    t.queued = true;
+    ready_.push_back(id);
+    workCv_.notify_one();
+}
+
+uint64_t TickScheduler::add(TaskFn fn, void *user, uint32_t intervalMs) {
+    if (!fn) return 0;
+
+    std::lock_guard<std::mutex> g(mu_);
+    if (stopping_) return 0;
+    ensureThreadsNoLock();
+
+    const uint64_t id = nextId_++;
+    Task &t = tasks_[id];
+    t.fn = fn;
+    t.user = user;
+    t.intervalMs = intervalMs ? intervalMs : 1000;
+    armNoLock(id, t, Clock::now());
+    return id;
+}
+
+void TickScheduler::remove(uint64_t id) {
+    std::unique_lock<std::mutex> lk(mu_);
+    auto it = tasks_.find(id);
+    if (it == tasks_.end()) return;
+
+    it->second.active = false;
+    it->second.seq++; // drop pending timers
+    doneCv_.wait(lk, [&] {
+        auto cur = tasks_.find(id);
+        return cur == tasks_.end() || !cur->second.running;
+    });
+    tasks_.erase(id);
+}
+
+void TickScheduler::setInterval(uint64_t id, uint32_t intervalMs) {
+    if (intervalMs == 0) return;
+
+    std::lock_guard<std::mutex> g(mu_);
+    auto it = tasks_.find(id);
+    if (it == tasks_.end()) return;
+
+    Task &t = it->second;
+    t.intervalMs = intervalMs;
+    // Re-arm from now so a shorter interval takes effect immediately.
+    if (t.active && !t.running && !t.queued) {
+        armNoLock(id, t, Clock::now() + std::chrono::milliseconds(intervalMs));
+    }
+}
+
+void TickScheduler::setActive(uint64_t id, bool active) {
+    std::lock_guard<std::mutex> g(mu_);
+    auto it = tasks_.find(id);
+    if (it == tasks_.end()) return;
+
+    Task &t = it->second;
+    if (t.active == active) return;
+    t.active = active;
+
+    if (!active) {
+        t.seq++; // cancel the pending timer; a running tick just won't re-arm
+        return;
+    }
+    if (!t.running && !t.queued) armNoLock(id, t, Clock::now());
+}
+
+void TickScheduler::wake(uint64_t id) {
+    std::lock_guard<std::mutex> g(mu_);
+    auto it = tasks_.find(id);
+    if (it == tasks_.end()) return;
+
+    Task &t = it->second;
+    if (t.running) {
+        t.rerun = true;
+        return;
+    }
+    t.seq++; // the pending timer is re-armed after this run
+    t.woken = true;
+    enqueueNoLock(id, t);
+}
+
+void TickScheduler::shutdown() {
+    {
+        std::lock_guard<std::mutex> g(mu_);
+        if (stopping_) return;
+        stopping_ = true;
+    }
+    timerCv_.notify_all();
+    workCv_.notify_all();
+
+    if (timerThread_.joinable()) timerThread_.join();
+    for (auto &w: workers_) {
+        if (w.joinable()) w.join();
+    }
+    workers_.clear();
+
+    std::lock_guard<std::mutex> g(mu_);
+    tasks_.clear();
+    ready_.clear();
+    timers_ = {};
+    doneCv_.notify_all();
+}
+
+void TickScheduler::timerMain() {
+    std::unique_lock<std::mutex> lk(mu_);
+    while (!stopping_) {
+        if (timers_.empty()) {
+            timerCv_.wait(lk);
+            continue;
+        }
+
+        const Timer top = timers_.top();
+        if (Clock::now() < top.due) {
+            timerCv_.wait_until(lk, top.due);
+            continue;
+        }
+        timers_.pop();
+
+        auto it = tasks_.find(top.id);
+        if (it == tasks_.end()) continue;
+        Task &t = it->second;
+        if (t.seq != top.seq || !t.active) continue; // stale entry
+
+        enqueueNoLock(top.id, t);
+    }
+}
+
+void TickScheduler::workerMain() {
+    std::unique_lock<std::mutex> lk(mu_);
+    while (true) {
+        workCv_.wait(lk, [&] { return stopping_ || !ready_.empty(); });
+        if (stopping_) return;
+
+        const uint64_t id = ready_.front();
+        ready_.pop_front();
+
+        auto it = tasks_.find(id);
+        if (it == tasks_.end()) continue;
+
+        Task &t = it->second;
+        t.queued = false;
+        if (!t.active && !t.woken) continue;
+        t.woken = false;
+
+        t.running = true;
+        TaskFn fn = t.fn;
+        void *user = t.user;
+
+        lk.unlock();
+        fn(user);
+        lk.lock();
+
+        // The map may have rehashed while unlocked; look the task up again.
+        it = tasks_.find(id);
+        if (it == tasks_.end()) {
+            doneCv_.notify_all();
+            continue;
+        }
+
+        Task &done = it->second;
+        done.running = false;
+        if (done.rerun) {
+            done.rerun = false;
+            done.woken = true;
+            enqueueNoLock(id, done);
+        } else if (done.active) {
+            // Fixed rate: stay on the original grid, dropping slots that already passed.
+            // A wake() that ran ahead of the timer keeps the pending slot.
+            const auto interval = std::chrono::milliseconds(done.intervalMs);
+            const auto now = Clock::now();
+            auto next = done.due;
+            if (next <= now) {
+                next += interval;
+                if (next <= now) next += ((now - next) / interval + 1) * interval;
+            }
+            armNoLock(id, done, next);
+        }
+        doneCv_.notify_all();
+    }
+}
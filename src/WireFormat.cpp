@@ -0,0 +1,190 @@
+#include "WireFormat.h"
+
+#include <cctype>
+
+#include <QCborMap>
+#include <QCborValue>
+
+#include "BasePlugin.h"
+
+// Minimal JSON syntax check (RFC 8259, no DOM). Snapshots pass through it once per
+// generation before they are spliced into broadcasts verbatim.
+namespace {
+struct JsonScan {
+    const char *p;
+    const char *end;
+    int depth = 0;
+
+    void ws() {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) p++;
+    }
+
+    bool lit(const char *s) {
+        for (; *s; s++, p++) {
+            if (p >= end || *p != *s) return false;
+        }
+        return true;
+    }
+
+    bool str() {
+        if (p >= end || *p != '"') return false;
+        for (p++; p < end; p++) {
+            const unsigned char c = (unsigned char) *p;
+            if (c == '"') { p++; return true; }
+            if (c < 0x20) return false;
+            if (c != '\\') continue;
+            if (++p >= end) return false;
+            switch (*p) {
+                case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+                    break;
+                case 'u':
+                    for (int i = 0; i < 4; i++) {
+                        if (++p >= end || !std::isxdigit((unsigned char) *p)) return false;
+                    }
+                    break;
+                default:
+                    return false;
+            }
+        }
+        return false;
+    }
+
+    bool digits() {
+        const char *s = p;
+        while (p < end && *p >= '0' && *p <= '9') p++;
+        return p > s;
+    }
+
+    bool num() {
+        if (p < end && *p == '-') p++;
+        if (p < end && *p == '0') p++;
+        else if (!digits()) return false;
+        if (p < end && *p == '.') { p++; if (!digits()) return false; }
+        if (p < end && (*p == 'e' || *p == 'E')) {
+            p++;
+            if (p < end && (*p == '+' || *p == '-')) p++;
+            if (!digits()) return false;
+        }
+        return true;
+    }
+
+    bool value() {
+        if (p >= end) return false;
+        switch (*p) {
+            case '{': return container('}');
+            case '[': return container(']');
+            case '"': return str();
+            case 't': return lit("true");
+            case 'f': return lit("false");
+            case 'n': return lit("null");
+            default: return num();
+        }
+    }
+
+    bool container(char close) {
+        if (++depth > 64) return false;
+        p++;
+        ws();
+        if (p < end && *p == close) { p++; depth--; return true; }
+        while (true) {
+            if (close == '}') {
+                if (!str()) return false;
+                ws();
+                if (p >= end || *p++ != ':') return false;
+                ws();
+            }
+            if (!value()) return false;
+            ws();
+            if (p >= end) return false;
+            if (*p == ',') { p++; ws(); continue; }
+            if (*p++ != close) return false;
+            depth--;
+            return true;
+        }
+    }
+};
+}
+
+QByteArray WireFormat::validView(const QByteArray &raw, uint32_t format) {
+    if (raw.isEmpty()) return {};
+    if (format == WA_FMT_CBOR) {
+        // Kept as written: CBOR clients get these bytes, JSON clients a transcode.
+        QCborParserError err;
+        const QCborValue cv = QCborValue::fromCbor(raw, &err);
+        if (err.error != QCborError::NoError || !cv.isMap() || cv.toMap().isEmpty()) return {};
+        return raw;
+    }
+    if (format != WA_FMT_JSON) return {};
+
+    JsonScan scan{raw.constData(), raw.constData() + raw.size()};
+    scan.ws();
+    const char *begin = scan.p;
+    if (scan.p >= scan.end || *scan.p != '{') return {};
+
+    // Same rule as for parsed views: an empty object is no snapshot.
+    scan.p++;
+    scan.ws();
+    if (scan.p < scan.end && *scan.p == '}') return {};
+    scan.p = begin;
+
+    if (!scan.container('}')) return {};
+    const char *last = scan.p;
+    scan.ws();
+    if (scan.p != scan.end) return {};
+
+    if (begin == raw.constData() && last == scan.end) return raw; // shares the buffer
+    return QByteArray(begin, (qsizetype) (last - begin));
+}
+
+// Objects nested in a snapshot that hold null members: a merge patch cannot
+// carry them (null removes the member), so such changes go out in full.
+static bool hasNullMember(const QJsonObject &o) {
+    for (auto it = o.begin(); it != o.end(); ++it) {
+        const QJsonValue v = it.value();
+        if (v.isNull()) return true;
+        if (v.isObject() && hasNullMember(v.toObject())) return true;
+    }
+    return false;
+}
+
+bool WireFormat::mergePatch(const QJsonObject &from, const QJsonObject &to, QJsonObject &patch) {
+    for (auto it = from.begin(); it != from.end(); ++it) {
+        if (!to.contains(it.key())) patch.insert(it.key(), QJsonValue::Null);
+    }
+    for (auto it = to.begin(); it != to.end(); ++it) {
+        const QJsonValue v = it.value();
+        const QJsonValue old = from.value(it.key());
+        if (old == v) continue;
+        if (v.isNull()) return false;
+        if (v.isObject() && old.isObject()) {
+            QJsonObject sub;
+            if (!mergePatch(old.toObject(), v.toObject(), sub)) return false;
+            if (!sub.isEmpty()) patch.insert(it.key(), sub);
+            continue;
+        }
+        if (v.isObject() && hasNullMember(v.toObject())) return false;
+        patch.insert(it.key(), v);
+    }
+    return true;
+}
+
+void WireFormat::cborHead(QByteArray &out, quint8 major, quint64 value) {
+    const char type = char(major << 5);
+    if (value < 24) {
+        out += char(type | char(value));
+        return;
+    }
+    int bytes = 8;
+    char info = 27;
+    if (value <= 0xff) { bytes = 1; info = 24; }
+    else if (value <= 0xffff) { bytes = 2; info = 25; }
+    else if (value <= 0xffffffffull) { bytes = 4; info = 26; }
+    out += char(type | info);
+    for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8) out += char((value >> shift) & 0xff);
+}
+
+void WireFormat::cborText(QByteArray &out, const QString &s) {
+    const QByteArray utf8 = s.toUtf8();
+    cborHead(out, 3, (quint64) utf8.size());
+    out += utf8;
+}
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include <QByteArray>
+
+#include "FrameDeflater.h"
+
+#if defined(WA_HAVE_ZLIB)
+#include <zlib.h>
+
+// The client's side: one raw inflate stream across all frames.
+class FrameInflater {
+public:
+    FrameInflater() { ok_ = inflateInit2(&zs_, -15) == Z_OK; }
+    ~FrameInflater() { if (ok_) inflateEnd(&zs_); }
+
+    bool inflate(const QByteArray &in, QByteArray &out) {
+        if (!ok_) return false;
+        zs_.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(in.constData()));
+        zs_.avail_in = static_cast<uInt>(in.size());
+        out.clear();
+        char buf[4096];
+        for (;;) {
+            zs_.next_out = reinterpret_cast<Bytef *>(buf);
+            zs_.avail_out = sizeof(buf);
+            const int rc = ::inflate(&zs_, Z_SYNC_FLUSH);
+            if (rc != Z_OK && rc != Z_BUF_ERROR) return false;
+            out.append(buf, (qsizetype) (sizeof(buf) - zs_.avail_out));
+            // Room left over: everything this frame holds has come out.
+            if (zs_.avail_out != 0) return zs_.avail_in == 0;
+        }
+    }
+
+private:
+    z_stream zs_{};
+    bool ok_ = false;
+};
+#endif
+
+static QByteArray frame(int i) {
+    QByteArray s = R"({"event":"update","payload":{"timestamp":)" + QByteArray::number(1700000000 + i) +
+                   R"(,"modules":{"basiccpu":{"usage":)" + QByteArray::number(i % 100) + R"(,"cores":[)";
+    for (int c = 0; c < 16; c++) s += QByteArray::number((i * 7 + c) % 100) + (c < 15 ? "," : "");
+    s += "]}}}}";
+    return s;
+}
+
+TEST(FrameDeflaterTest, RoundTripsAcrossFrames) {
+    if (!FrameDeflater::available()) GTEST_SKIP() << "built without zlib";
+#if defined(WA_HAVE_ZLIB)
+    FrameDeflater deflater;
+    FrameInflater inflater;
+
+    qsizetype firstSize = 0;
+    qsizetype laterSize = 0;
+    for (int i = 0; i < 20; i++) {
+        const QByteArray in = frame(i);
+        QByteArray compressed("prefix");
+        ASSERT_TRUE(deflater.compress(in, compressed));
+        ASSERT_TRUE(compressed.startsWith("prefix")); // appends
+
+        // Every frame ends with a sync flush: it inflates on its own, in order.
+        const QByteArray body = compressed.mid(6);
+        EXPECT_TRUE(body.endsWith(QByteArray("\x00\x00\xff\xff", 4)));
+        QByteArray out;
+        ASSERT_TRUE(inflater.inflate(body, out));
+        EXPECT_EQ(out, in);
+
+        if (i == 0) firstSize = body.size();
+        else laterSize = std::max(laterSize, body.size());
+    }
+    // The context carries over: repeated keys cost back-references only.
+    EXPECT_LT(laterSize, firstSize);
+#endif
+}
+
+TEST(FrameDeflaterTest, RoundTripsLargeAndEmptyFrames) {
+    if (!FrameDeflater::available()) GTEST_SKIP() << "built without zlib";
+#if defined(WA_HAVE_ZLIB)
+    FrameDeflater deflater;
+    FrameInflater inflater;
+
+    QByteArray large;
+    for (int i = 0; i < 20000; i++) large += frame(i).left(40 + i % 30);
+    const QByteArray frames[] = {large, QByteArray(), frame(1), large};
+    for (const QByteArray &in: frames) {
+        QByteArray compressed;
+        ASSERT_TRUE(deflater.compress(in, compressed));
+        QByteArray out;
+        ASSERT_TRUE(inflater.inflate(compressed, out));
+        EXPECT_EQ(out, in);
+    }
+#endif
+}
+
+TEST(FrameDeflaterTest, UnavailableWithoutZlib) {
+    if (FrameDeflater::available()) GTEST_SKIP() << "built with zlib";
+    FrameDeflater deflater;
+    QByteArray out;
+    EXPECT_FALSE(deflater.compress("abc", out));
+    EXPECT_TRUE(out.isEmpty());
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+#include <QUuid>
+
+#include "SnapshotRing.h"
+
+static QString uniqueKey() {
+    return "wa-test-ring-" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+}
+
+// Generation g carries (g % 50) + 1 bytes of (char) g: a torn read shows up as a
+// wrong length or a mixed byte.
+static QByteArray payload(uint64_t generation) {
+    return QByteArray((qsizetype) (generation % 50) + 1, (char) generation);
+}
+
+TEST(SnapshotRingTest, PublishesAndReadsLatest) {
+    SnapshotRing ring;
+    ASSERT_TRUE(ring.create(uniqueKey(), 64));
+
+    QByteArray out;
+    uint64_t gen = 0;
+    EXPECT_EQ(ring.readLatest(0, out, gen), SnapshotRing::ReadResult::Empty);
+
+    ring.publish(1, "abc", 3);
+    ASSERT_EQ(ring.readLatest(0, out, gen), SnapshotRing::ReadResult::Ok);
+    EXPECT_EQ(gen, 1u);
+    EXPECT_EQ(out, QByteArray("abc"));
+    EXPECT_EQ(ring.readLatest(1, out, gen), SnapshotRing::ReadResult::Unchanged);
+
+    ring.publish(2, "", 0);
+    ASSERT_EQ(ring.readLatest(1, out, gen), SnapshotRing::ReadResult::Ok);
+    EXPECT_EQ(gen, 2u);
+    EXPECT_TRUE(out.isEmpty());
+}
+
+TEST(SnapshotRingTest, MarksOversizeSnapshots) {
+    SnapshotRing ring;
+    ASSERT_TRUE(ring.create(uniqueKey(), 16));
+
+    const QByteArray big(17, 'x');
+    ring.publish(5, big.constData(), (uint32_t) big.size());
+    QByteArray out;
+    uint64_t gen = 0;
+    EXPECT_EQ(ring.readLatest(0, out, gen), SnapshotRing::ReadResult::Oversize);
+    EXPECT_EQ(gen, 5u);
+
+    ring.publish(6, big.constData(), 16);
+    EXPECT_EQ(ring.readLatest(5, out, gen), SnapshotRing::ReadResult::Ok);
+    EXPECT_EQ(out, big.left(16));
+}
+
+TEST(SnapshotRingTest, AttachSeesWriterSegment) {
+    const QString key = uniqueKey();
+    SnapshotRing host;
+    ASSERT_TRUE(host.create(key, 32, 2));
+
+    SnapshotRing worker;
+    ASSERT_TRUE(worker.attach(key));
+    EXPECT_EQ(worker.slotBytes(), 32u);
+
+    worker.publish(7, "hello", 5);
+    QByteArray out;
+    uint64_t gen = 0;
+    ASSERT_EQ(host.readLatest(0, out, gen), SnapshotRing::ReadResult::Ok);
+    EXPECT_EQ(gen, 7u);
+    EXPECT_EQ(out, QByteArray("hello"));
+}
+
+TEST(SnapshotRingTest, SharesStatsRecord) {
+    const QString key = uniqueKey();
+    SnapshotRing host;
+    ASSERT_TRUE(host.create(key, 32));
+    SnapshotRing worker;
+    ASSERT_TRUE(worker.attach(key));
+
+    uint64_t stats[4] = {};
+    EXPECT_FALSE(host.readStats(stats, sizeof stats));
+
+    const uint64_t published[4] = {1, 2, 3, 4};
+    worker.publishStats(published, sizeof published);
+    ASSERT_TRUE(host.readStats(stats, sizeof stats));
+    EXPECT_EQ(stats[3], 4u);
+
+    // A record of another size (other build) is not handed out.
+    EXPECT_FALSE(host.readStats(stats, sizeof stats - 8));
+}
+
+TEST(SnapshotRingTest, ReadersNeverSeeTornSnapshots) {
+    // Two slots: the writer comes back to the slot a reader is copying every
+    // other generation, so the seqlock retry path is exercised constantly.
+    const QString key = uniqueKey();
+    SnapshotRing writerRing;
+    ASSERT_TRUE(writerRing.create(key, 64, 2));
+    SnapshotRing readerRing;
+    ASSERT_TRUE(readerRing.attach(key));
+
+    constexpr uint64_t kGenerations = 200000;
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (uint64_t g = 1; g <= kGenerations; g++) {
+            const QByteArray p = payload(g);
+            writerRing.publish(g, p.constData(), (uint32_t) p.size());
+        }
+        done.store(true);
+    });
+
+    std::atomic<uint64_t> torn{0};
+    std::atomic<uint64_t> backwards{0};
+    std::atomic<uint64_t> reads{0};
+    const auto reader = [&] {
+        QByteArray out;
+        uint64_t last = 0;
+        while (!done.load()) {
+            uint64_t gen = 0;
+            if (readerRing.readLatest(last, out, gen) != SnapshotRing::ReadResult::Ok) continue;
+            reads.fetch_add(1);
+            if (gen < last) backwards.fetch_add(1);
+            if (out != payload(gen)) torn.fetch_add(1);
+            last = gen;
+        }
+    };
+    std::thread r1(reader);
+    std::thread r2(reader);
+    writer.join();
+    r1.join();
+    r2.join();
+
+    EXPECT_EQ(torn.load(), 0u);
+    EXPECT_EQ(backwards.load(), 0u);
+    EXPECT_GT(reads.load(), 0u);
+
+    QByteArray out;
+    uint64_t gen = 0;
+    ASSERT_EQ(readerRing.readLatest(0, out, gen), SnapshotRing::ReadResult::Ok);
+    EXPECT_EQ(gen, kGenerations);
+    EXPECT_EQ(out, payload(kGenerations));
+}
@@ -0,0 +1,222 @@
+#include <gtest/gtest.h>
+
+#include <limits>
+
+#include <QCborArray>
+#include <QCborMap>
+#include <QCborValue>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include "BasePlugin.h"
+#include "WireFormat.h"
+
+static QJsonObject obj(const char *json) {
+    return QJsonDocument::fromJson(QByteArray(json)).object();
+}
+
+// RFC 7386 apply, the client's side of mergePatch().
+static QJsonObject applyMergePatch(QJsonObject target, const QJsonObject &patch) {
+    for (auto it = patch.begin(); it != patch.end(); ++it) {
+        const QJsonValue v = it.value();
+        if (v.isNull()) {
+            target.remove(it.key());
+        } else if (v.isObject()) {
+            target.insert(it.key(), applyMergePatch(target.value(it.key()).toObject(), v.toObject()));
+        } else {
+            target.insert(it.key(), v);
+        }
+    }
+    return target;
+}
+
+static QByteArray nested(int depth) {
+    QByteArray s;
+    for (int i = 0; i < depth; i++) s += "{\"a\":";
+    s += "1";
+    for (int i = 0; i < depth; i++) s += "}";
+    return s;
+}
+
+// ---- validView ----
+
+TEST(ValidViewTest, KeepsJsonObjectVerbatim) {
+    const QByteArray raw = R"({"cpu":{"usage":12.5,"cores":[1,-2,3e4]},"name":"a\"b\u00e9\n","ok":true,"none":null})";
+    const QByteArray out = WireFormat::validView(raw, WA_FMT_JSON);
+    EXPECT_EQ(out, raw);
+}
+
+TEST(ValidViewTest, TrimsSurroundingWhitespace) {
+    EXPECT_EQ(WireFormat::validView(" \r\n{ \"a\" : 1 }\t ", WA_FMT_JSON), QByteArray("{ \"a\" : 1 }"));
+}
+
+TEST(ValidViewTest, RejectsMalformedJson) {
+    const char *bad[] = {
+        "",
+        "{}",
+        " { } ",
+        "[1,2]",
+        "\"text\"",
+        "{\"a\":1",
+        "{\"a\":1}}",
+        "{\"a\" 1}",
+        "{a:1}",
+        "{\"a\":01}",
+        "{\"a\":1.}",
+        "{\"a\":-}",
+        "{\"a\":1e}",
+        "{\"a\":tru}",
+        "{\"a\":[1,]}",
+        "{\"a\":1,}",
+        "{\"a\":\"\\x\"}",
+        "{\"a\":\"\\u12G4\"}",
+        "{\"a\":\"line\nbreak\"}",
+        "{\"a\":\"open}",
+        "{\"a\":1} {\"b\":2}",
+    };
+    for (const char *s: bad) {
+        EXPECT_TRUE(WireFormat::validView(QByteArray(s), WA_FMT_JSON).isEmpty()) << s;
+    }
+}
+
+TEST(ValidViewTest, LimitsNesting) {
+    EXPECT_FALSE(WireFormat::validView(nested(64), WA_FMT_JSON).isEmpty());
+    EXPECT_TRUE(WireFormat::validView(nested(65), WA_FMT_JSON).isEmpty());
+}
+
+TEST(ValidViewTest, KeepsCborMapAsWritten) {
+    QCborMap m;
+    m.insert(QStringLiteral("usage"), 12.5);
+    m.insert(QStringLiteral("name"), QStringLiteral("cpu"));
+    const QByteArray raw = m.toCborValue().toCbor();
+    EXPECT_EQ(WireFormat::validView(raw, WA_FMT_CBOR), raw);
+}
+
+TEST(ValidViewTest, RejectsInvalidCbor) {
+    EXPECT_TRUE(WireFormat::validView(QCborMap().toCborValue().toCbor(), WA_FMT_CBOR).isEmpty());
+    EXPECT_TRUE(WireFormat::validView(QCborValue(42).toCbor(), WA_FMT_CBOR).isEmpty());
+    EXPECT_TRUE(WireFormat::validView(QByteArray("\xA1\x61", 2), WA_FMT_CBOR).isEmpty()); // truncated
+    EXPECT_TRUE(WireFormat::validView("{\"a\":1}", WA_FMT_CBOR).isEmpty());
+}
+
+TEST(ValidViewTest, RejectsUnknownFormat) {
+    EXPECT_TRUE(WireFormat::validView("{\"a\":1}", 7).isEmpty());
+}
+
+// ---- mergePatch ----
+
+TEST(MergePatchTest, RoundTripsChangesAndRemovals) {
+    const QJsonObject from = obj(R"({"a":1,"b":{"c":2,"d":{"e":3,"f":4}},"g":[1,2],"h":"x","i":{"j":1}})");
+    const QJsonObject to = obj(R"({"a":2,"b":{"c":2,"d":{"e":3}},"g":[1,2,3],"i":5,"k":{"l":true}})");
+
+    QJsonObject patch;
+    ASSERT_TRUE(WireFormat::mergePatch(from, to, patch));
+    EXPECT_EQ(patch, obj(R"({"a":2,"b":{"d":{"f":null}},"g":[1,2,3],"h":null,"i":5,"k":{"l":true}})"));
+    EXPECT_EQ(applyMergePatch(from, patch), to);
+}
+
+TEST(MergePatchTest, RemovesWholeNestedObject) {
+    const QJsonObject from = obj(R"({"a":{"b":{"c":1}},"d":1})");
+    const QJsonObject to = obj(R"({"a":{},"d":1})");
+
+    QJsonObject patch;
+    ASSERT_TRUE(WireFormat::mergePatch(from, to, patch));
+    EXPECT_EQ(patch, obj(R"({"a":{"b":null}})"));
+    EXPECT_EQ(applyMergePatch(from, patch), to);
+}
+
+TEST(MergePatchTest, ReplacesScalarWithObjectAndBack) {
+    const QJsonObject from = obj(R"({"a":1,"b":{"c":1}})");
+    const QJsonObject to = obj(R"({"a":{"x":[1]},"b":false})");
+
+    QJsonObject patch;
+    ASSERT_TRUE(WireFormat::mergePatch(from, to, patch));
+    EXPECT_EQ(applyMergePatch(from, patch), to);
+}
+
+TEST(MergePatchTest, UnchangedGivesEmptyPatch) {
+    const QJsonObject o = obj(R"({"a":1,"b":{"c":[1,{"d":null}]}})");
+
+    QJsonObject patch;
+    ASSERT_TRUE(WireFormat::mergePatch(o, o, patch));
+    EXPECT_TRUE(patch.isEmpty());
+}
+
+TEST(MergePatchTest, RefusesNullValues) {
+    QJsonObject patch;
+    EXPECT_FALSE(WireFormat::mergePatch(obj(R"({"a":1})"), obj(R"({"a":null})"), patch));
+
+    patch = {};
+    EXPECT_FALSE(WireFormat::mergePatch(obj(R"({"a":{"b":1}})"), obj(R"({"a":{"b":null}})"), patch));
+
+    patch = {};
+    EXPECT_FALSE(WireFormat::mergePatch(obj(R"({"a":1})"), obj(R"({"a":{"b":{"c":null}}})"), patch));
+}
+
+TEST(MergePatchTest, NullsInsideArraysAreFine) {
+    const QJsonObject from = obj(R"({"a":[1]})");
+    const QJsonObject to = obj(R"({"a":[null,{"b":null}]})");
+
+    QJsonObject patch;
+    ASSERT_TRUE(WireFormat::mergePatch(from, to, patch));
+    EXPECT_EQ(applyMergePatch(from, patch), to);
+}
+
+// ---- CBOR heads ----
+
+static QByteArray head(quint8 major, quint64 value) {
+    QByteArray out;
+    WireFormat::cborHead(out, major, value);
+    return out;
+}
+
+TEST(CborHeadTest, UsesShortestForm) {
+    EXPECT_EQ(head(0, 0), QByteArray::fromHex("00"));
+    EXPECT_EQ(head(0, 23), QByteArray::fromHex("17"));
+    EXPECT_EQ(head(0, 24), QByteArray::fromHex("1818"));
+    EXPECT_EQ(head(0, 0xff), QByteArray::fromHex("18ff"));
+    EXPECT_EQ(head(0, 0x100), QByteArray::fromHex("190100"));
+    EXPECT_EQ(head(0, 0xffff), QByteArray::fromHex("19ffff"));
+    EXPECT_EQ(head(0, 0x10000), QByteArray::fromHex("1a00010000"));
+    EXPECT_EQ(head(0, 0xffffffffull), QByteArray::fromHex("1affffffff"));
+    EXPECT_EQ(head(0, 0x100000000ull), QByteArray::fromHex("1b0000000100000000"));
+}
+
+TEST(CborHeadTest, EncodesMajorType) {
+    EXPECT_EQ(head(1, 0), QByteArray::fromHex("20"));
+    EXPECT_EQ(head(3, 5), QByteArray::fromHex("65"));
+    EXPECT_EQ(head(4, 300), QByteArray::fromHex("99012c"));
+    EXPECT_EQ(head(5, 2), QByteArray::fromHex("a2"));
+}
+
+TEST(CborHeadTest, DecodesAsIntegers) {
+    const quint64 values[] = {0, 1, 23, 24, 255, 256, 65535, 65536, 0xffffffffull, 0x100000000ull,
+                              (quint64) std::numeric_limits<qint64>::max()};
+    for (const quint64 v: values) {
+        EXPECT_EQ(QCborValue::fromCbor(head(0, v)).toInteger(), (qint64) v) << v;
+    }
+}
+
+TEST(CborHeadTest, TextCountsUtf8Bytes) {
+    const QString s = QString::fromUtf8("h\xC3\xA9llo \xE2\x82\xAC");
+    QByteArray out;
+    WireFormat::cborText(out, s);
+    EXPECT_EQ((quint8) out[0], 0x60 | 10);
+    EXPECT_EQ(QCborValue::fromCbor(out).toString(), s);
+}
+
+TEST(CborHeadTest, BuildsDecodableMap) {
+    QByteArray out;
+    WireFormat::cborHead(out, 5, 2);
+    WireFormat::cborText(out, QStringLiteral("n"));
+    WireFormat::cborHead(out, 1, 99); // -100
+    WireFormat::cborText(out, QStringLiteral("list"));
+    WireFormat::cborHead(out, 4, 30);
+    for (int i = 0; i < 30; i++) WireFormat::cborHead(out, 0, (quint64) i * 1000);
+
+    const QCborMap m = QCborValue::fromCbor(out).toMap();
+    EXPECT_EQ(m.value(QStringLiteral("n")).toInteger(), -100);
+    const QCborArray list = m.value(QStringLiteral("list")).toArray();
+    ASSERT_EQ(list.size(), 30);
+    EXPECT_EQ(list.at(29).toInteger(), 29000);
+}